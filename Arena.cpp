@@ -0,0 +1,57 @@
+//==================================================================================================
+//  Arena.cpp is the scratch memory arena class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#include "Arena.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+
+Arena::~Arena( void ) {
+  while ( pFirst != 0 ) {
+    Block * pNext = pFirst->pNext;
+    free( pFirst );
+    pFirst = pNext;
+  }
+}
+
+void * Arena::allocate( size_t size ) {
+  size = (size + ALIGNMENT - 1) & ~(size_t)(ALIGNMENT - 1);
+  while ( pCurrent == 0  ||  pCurrent->size - used < size ) {
+    Block * pNext = pCurrent ? pCurrent->pNext : pFirst;
+    if ( pNext == 0  ||  pNext->size < size ) {    // a new block, ahead of any too small to use
+      size_t blockBytes = size > blockSize ? size : blockSize;
+      Block * pBlock    = (Block *)malloc( sizeof( Block ) + blockBytes );
+      if ( pBlock == 0 ) {
+        fprintf( stderr, "*** Out of memory (%lu bytes) ***\n", (unsigned long)blockBytes );
+        abort();
+      }
+      pBlock->pNext = pNext;
+      pBlock->size  = blockBytes;
+      if ( pCurrent != 0 ) {
+        pCurrent->pNext = pBlock;
+      } else {
+        pFirst          = pBlock;
+      }
+      pNext = pBlock;
+    }
+    pCurrent = pNext;
+    used     = 0;
+  }
+  void * pResult = (char *)(pCurrent + 1) + used;
+  used += size;
+  return pResult;
+}
@@ -0,0 +1,57 @@
+//==================================================================================================
+//  Arena.hpp is the scratch memory arena class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  A bump-pointer arena for memory needed only while converting one file.
+//  Blocks are kept across reset(), so once an arena has seen its largest
+//  file, further files allocate nothing from the heap.
+
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <stddef.h>
+
+class Arena {
+  struct Block {
+    Block  * pNext;
+    size_t   size;        // bytes following this header
+  };
+
+  size_t   const blockSize;
+  Block  *       pFirst,
+         *       pCurrent;
+  size_t         used;    // bytes of pCurrent in use
+
+  Arena(             Arena const & rhs );  // Intentionally not implemented
+  Arena & operator=( Arena const & rhs );  // Intentionally not implemented
+
+ public:
+  enum {
+    ALIGNMENT = 8
+  };
+
+  Arena( size_t blockSize = 0x10000 ) : blockSize( blockSize ), pFirst( 0 ), pCurrent( 0 ), used( 0 ) {}
+  ~Arena( void );
+
+  void * allocate( size_t size );   // never fails;  aborts if the heap is exhausted
+  void   reset(    void ) {         // frees everything allocated, keeping the blocks
+    pCurrent = pFirst;
+    used     = 0;
+  }
+};
+
+#endif
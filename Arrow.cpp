@@ -0,0 +1,479 @@
+//==================================================================================================
+//  Arrow.cpp is the columnar (Arrow IPC) export class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#include "Arrow.hpp"
+#include "Json.hpp"
+#include "Stats.hpp"
+
+enum {                    // from Arrow's Schema.fbs, Message.fbs & File.fbs
+  METADATA_V5        = 4,
+  HEADER_SCHEMA      = 1,
+  HEADER_DICTIONARY  = 2,
+  HEADER_RECORDS     = 3,
+  TYPE_INT           = 2,
+  TYPE_FLOAT         = 3,
+  TYPE_UTF8          = 5,
+  TYPE_BOOL          = 6,
+  TYPE_FIXED         = 15,
+  PRECISION_DOUBLE   = 2
+};
+
+static uint8_t const zeros[ 8 ] = { 0 };
+
+static size_t pad8( size_t size ) {
+  return (size + 7) & ~(size_t)7;
+}
+
+// A flatbuffer written front to back:  each table is written before the
+// strings, vectors & tables it refers to, so every offset points forward.
+// Each field of a table gets its own 8-byte slot, so every scalar is aligned.
+class FlatBuffer {
+  uint8_t * const pBuffer;
+  size_t    const limit;
+  size_t          used,
+                  root;   // 0 until the first table
+  FlatBuffer(             void                   );  // Intentionally not implemented
+  FlatBuffer(             FlatBuffer const & rhs );  // Intentionally not implemented
+  FlatBuffer & operator=( FlatBuffer const & rhs );  // Intentionally not implemented
+
+  size_t reserve( size_t size, size_t alignment, size_t remainder = 0 ) {
+    while ( used % alignment != remainder ) {
+      pBuffer[ used++ ] = 0;
+    }
+    assert( used + size <= limit );
+    memset( & pBuffer[ used ], 0, size );
+    used += size;
+    return used - size;
+  }
+
+ public:
+  struct Table {
+    size_t vtable,
+           table;
+  };
+
+  FlatBuffer( uint8_t * pBuffer, size_t limit ) : pBuffer( pBuffer ), limit( limit ), used( 0 ) {
+    clear();
+  }
+  void            clear(   void ) {
+    used = 0;
+    root = 0;
+    reserve( 4, 4 );      // the root table's offset
+  }
+  void            put(     size_t position, uint64_t value, size_t size ) {   // little-endian
+    for ( size_t index = 0;  index < size;  index++, value >>= 8 ) {
+      pBuffer[ position + index ] = (uint8_t)value;
+    }
+  }
+  Table           table(   size_t fields ) {   // the first one is the root
+    Table result;
+    result.vtable = reserve( 4 + 2 * fields, 2 );
+    result.table  = reserve( 8 + 8 * fields, 8 );
+    put( result.vtable,     4 + 2 * fields,                2 );
+    put( result.vtable + 2, 8 + 8 * fields,                2 );
+    put( result.table,      result.table - result.vtable,  4 );
+    if ( root == 0 ) {
+      root = result.table;
+      put( 0, root, 4 );
+    }
+    return result;
+  }
+  void            scalar(  Table const & table, size_t field, uint64_t value, size_t size ) {
+    put( table.vtable + 4 + 2 * field, 8 + 8 * field, 2 );
+    put( table.table  + 8 + 8 * field, value,         size );
+  }
+  void            offset(  Table const & table, size_t field, size_t target ) {
+    scalar( table, field, target - (table.table + 8 + 8 * field), 4 );
+  }
+  void            element( size_t vector, size_t index, size_t target ) {  // of a vector of offsets
+    size_t position = vector + 4 + 4 * index;
+    put( position, target - position, 4 );
+  }
+  size_t          string(  char const * pString ) {
+    size_t length   = strlen( pString );
+    size_t position = reserve( 4 + length + 1, 4 );
+    put( position, length, 4 );
+    memcpy( & pBuffer[ position + 4 ], pString, length );
+    return position;
+  }
+  size_t          vector(  size_t count, size_t size ) {   // the elements follow the returned count
+    size_t position = size % 8 == 0 ? reserve( 4 + count * size, 8, 4 ) : reserve( 4 + count * size, 4 );
+    put( position, count, 4 );
+    return position;
+  }
+  uint8_t const * finish(  size_t & size ) {
+    reserve( 0, 8 );
+    size = used;
+    return pBuffer;
+  }
+};
+
+struct Column {
+  size_t        width,        // FIXED:  bytes;  DICTIONARY:  entries
+                textSize,     // DICTIONARY:  bytes of entry text (while sizing, of all values)
+                dataSize;
+  uint8_t     * pData;        // the values, or DICTIONARY indices
+  uint32_t    * pOffsets;     // DICTIONARY:  of each entry's text, & the end
+  char        * pText;
+  Arrow::Type   type;
+  uint32_t      fill;
+};
+
+class ArrowWriter {       // the messages of the file, with their positions
+  Output     & output;
+  FlatBuffer & flat;
+  uint64_t     position;
+  ArrowWriter(             void                    );  // Intentionally not implemented
+  ArrowWriter(             ArrowWriter const & rhs );  // Intentionally not implemented
+  ArrowWriter & operator=( ArrowWriter const & rhs );  // Intentionally not implemented
+ public:
+  struct Block {
+    uint64_t offset,
+             metadata,
+             body;
+  };
+
+  ArrowWriter( Output & output, FlatBuffer & flat ) : output( output ), flat( flat ), position( 0 ) {}
+  void     write( void const * pData, size_t size ) {
+    if ( size > 0 ) {
+      output.write( pData, size );
+    }
+    if ( pad8( size ) > size ) {
+      output.write( zeros, pad8( size ) - size );
+    }
+    position += pad8( size );
+  }
+  uint64_t getPosition( void ) const {
+    return position;
+  }
+  Block    message( uint8_t const * const * ppBuffers, size_t const * pSizes, size_t buffers ) {
+    Block           block;
+    size_t          size;
+    uint8_t const * pMetadata = flat.finish( size );
+    uint8_t         prefix[ 8 ] = { 0xFF, 0xFF, 0xFF, 0xFF };
+    for ( size_t index = 0;  index < 4;  index++ ) {
+      prefix[ 4 + index ] = (uint8_t)(size >> 8 * index);
+    }
+    block.offset   = position;
+    block.metadata = 8 + size;
+    write( prefix,    sizeof prefix );
+    write( pMetadata, size );
+    for ( size_t index = 0;  index < buffers;  index++ ) {
+      write( ppBuffers[ index ], pSizes[ index ] );
+    }
+    block.body = position - block.offset - block.metadata;
+    flat.clear();
+    return block;
+  }
+};
+
+static void putSchema( FlatBuffer             & flat,
+                       FlatBuffer::Table const & parent,
+                       size_t                   field,
+                       CsvField         const * csvField,
+                       Column           const * pColumns,
+                       size_t                   count ) {
+  FlatBuffer::Table schema = flat.table( 2 );   // Little endian, the default
+  flat.offset( parent, field, schema.table );
+  size_t fields = flat.vector( count, 4 );
+  flat.offset( schema, 1, fields );
+  for ( size_t index = 0;  index < count;  index++ ) {
+    Column    const & column = pColumns[ index ];
+    FlatBuffer::Table field  = flat.table( 5 );  // not nullable, the default
+    flat.element( fields, index, field.table );
+    flat.offset( field, 0, flat.string( csvField[ index ].fieldName ) );
+    FlatBuffer::Table type;
+    switch ( column.type ) {
+      case Arrow::BOOL:
+        flat.scalar( field, 2, TYPE_BOOL, 1 );
+        type = flat.table( 0 );
+        break;
+      case Arrow::UINT32:
+        flat.scalar( field, 2, TYPE_INT, 1 );
+        type = flat.table( 2 );
+        flat.scalar( type, 0, 32, 4 );
+        flat.scalar( type, 1, 0,  1 );
+        break;
+      case Arrow::FLOAT64:
+        flat.scalar( field, 2, TYPE_FLOAT, 1 );
+        type = flat.table( 1 );
+        flat.scalar( type, 0, PRECISION_DOUBLE, 2 );
+        break;
+      case Arrow::FIXED:
+        flat.scalar( field, 2, TYPE_FIXED, 1 );
+        type = flat.table( 1 );
+        flat.scalar( type, 0, column.width, 4 );
+        break;
+      case Arrow::DICTIONARY:
+        flat.scalar( field, 2, TYPE_UTF8, 1 );
+        type = flat.table( 0 );
+        break;
+    }
+    flat.offset( field, 3, type.table );
+    if ( column.type == Arrow::DICTIONARY ) {
+      FlatBuffer::Table dictionary = flat.table( 2 );
+      flat.offset( field, 4, dictionary.table );
+      flat.scalar( dictionary, 0, index, 8 );           // its id
+      FlatBuffer::Table indexType  = flat.table( 2 );
+      flat.offset( dictionary, 1, indexType.table );
+      flat.scalar( indexType,  0, 16, 4 );
+      flat.scalar( indexType,  1, 1,  1 );
+    }
+  }
+}
+
+static void putRecords( FlatBuffer              & flat,
+                        FlatBuffer::Table const & parent,
+                        size_t                    field,
+                        size_t                    rows,
+                        size_t                    nodes,
+                        size_t            const * pSizes,
+                        size_t                    buffers ) {
+  FlatBuffer::Table records = flat.table( 3 );
+  flat.offset( parent, field, records.table );
+  flat.scalar( records, 0, rows, 8 );
+  size_t vector = flat.vector( nodes, 16 );
+  flat.offset( records, 1, vector );
+  for ( size_t index = 0;  index < nodes;  index++ ) {
+    flat.put( vector + 4 + 16 * index, rows, 8 );       // length;  no nulls
+  }
+  vector = flat.vector( buffers, 16 );
+  flat.offset( records, 2, vector );
+  for ( size_t index = 0, offset = 0;  index < buffers;  offset += pad8( pSizes[ index++ ] ) ) {
+    flat.put( vector + 4 + 16 * index,     offset,          8 );
+    flat.put( vector + 4 + 16 * index + 8, pSizes[ index ], 8 );
+  }
+}
+
+static FlatBuffer::Table putMessage( FlatBuffer & flat, size_t header, uint64_t body ) {
+  FlatBuffer::Table message = flat.table( 4 );
+  flat.scalar( message, 0, METADATA_V5, 2 );
+  flat.scalar( message, 1, header,      1 );
+  flat.scalar( message, 3, body,        8 );
+  return message;
+}
+
+static uint64_t bodySize( size_t const * pSizes, size_t buffers ) {
+  uint64_t size = 0;
+  for ( size_t index = 0;  index < buffers;  index++ ) {
+    size += pad8( pSizes[ index ] );
+  }
+  return size;
+}
+
+static size_t unquote( char const * pValue, char * pText ) {   // escape()'s quoting removed
+  size_t length = strlen( pValue ),
+         count  = 0;
+  if ( length < 2  ||  pValue[ 0 ] != '"'  ||  pValue[ length - 1 ] != '"' ) {
+    memcpy( pText, pValue, length + 1 );
+    return length;
+  }
+  for ( size_t index = 1;  index < length - 1;  index++ ) {
+    if ( pValue[ index ] == '\\'  &&  index + 2 < length ) {
+      index++;
+    }
+    pText[ count++ ] = pValue[ index ];
+  }
+  pText[ count ] = 0;
+  return count;
+}
+
+bool Arrow::dump( Radio    const * pRadio,
+                  Output         & output,
+                  uint8_t  const * pSelect,
+                  CsvField const * pPlan ) {
+  Stats::Span span( Stats::DUMP );
+  CsvField const * const csvField = pPlan ? pPlan : pRadio->csvHeader();
+  Arena  arena;
+  size_t count = 0,
+         rows  = 0;
+  for (  ;  csvField[ count ].fieldName != 0;  count++ );
+  Column * pColumns = (Column *)arena.allocate( count * sizeof (Column) );
+  memset( pColumns, 0, count * sizeof (Column) );
+  for ( size_t fieldIndex = 0;  fieldIndex < count;  fieldIndex++ ) {   // typed by the model, not the channels
+    Column & column = pColumns[ fieldIndex ];
+    switch ( fieldIndex ? pRadio->getFieldType( csvField[ fieldIndex ].getField, & column.width ) : CsvField::WHOLE ) {
+      case CsvField::ON_OFF:   column.type = BOOL;        break;
+      case CsvField::WHOLE:    column.type = UINT32;      break;
+      case CsvField::DECIMAL:  column.type = FLOAT64;     break;
+      case CsvField::TEXT:     column.type = FIXED;       break;
+      case CsvField::LABEL:    column.type = DICTIONARY;  break;
+    }
+  }
+
+  size_t offset = pRadio->getOffset();
+  char   work[ 1024 ],
+         text[ 1024 ];
+  for ( size_t lineIndex = 0;  lineIndex < pRadio->getCount();  lineIndex++ ) {   // size the buffers
+    if ( (pSelect != 0  &&  !pSelect[ lineIndex ])  ||  !(pRadio->*csvField[ 0 ].getField)( lineIndex, 0 ) ) {
+      continue;
+    }
+    rows++;
+    for ( size_t fieldIndex = 1;  fieldIndex < count;  fieldIndex++ ) {
+      Column & column = pColumns[ fieldIndex ];
+      if ( column.type == DICTIONARY ) {
+        (pRadio->*csvField[ fieldIndex ].getField)( lineIndex, work );
+        column.textSize += unquote( work, text );
+      }
+    }
+  }
+  for ( size_t fieldIndex = 0;  fieldIndex < count;  fieldIndex++ ) {
+    Column & column = pColumns[ fieldIndex ];
+    switch ( column.type ) {
+      case BOOL:        column.dataSize = (rows + 7) / 8;                         break;
+      case UINT32:      column.dataSize = rows * sizeof (uint32_t);               break;
+      case FLOAT64:     column.dataSize = rows * sizeof (double);                 break;
+      case FIXED:       column.width    = column.width ? column.width : 1;
+                        column.dataSize = rows * column.width;                    break;
+      case DICTIONARY:  column.dataSize = rows * sizeof (int16_t);
+                        column.pOffsets = (uint32_t *)arena.allocate( (rows + 1) * sizeof (uint32_t) );
+                        column.pText    = (char     *)arena.allocate( column.textSize + 1 );
+                        column.pOffsets[ 0 ] = 0;
+                        column.width    = 0;
+                        column.textSize = 0;                                      break;
+    }
+    column.pData = (uint8_t *)arena.allocate( column.dataSize + 1 );
+    memset( column.pData, 0, column.dataSize );
+  }
+
+  size_t row    = 0,
+         errors = 0;
+  for ( size_t lineIndex = 0;  lineIndex < pRadio->getCount();  lineIndex++ ) {   // fill them
+    if ( (pSelect != 0  &&  !pSelect[ lineIndex ])  ||  !(pRadio->*csvField[ 0 ].getField)( lineIndex, 0 ) ) {
+      continue;
+    }
+    sprintf( work, "%d", (int)(lineIndex + offset) );
+    for ( size_t fieldIndex = 0;  fieldIndex < count;  fieldIndex++ ) {
+      Column & column = pColumns[ fieldIndex ];
+      if ( fieldIndex > 0  &&  !(pRadio->*csvField[ fieldIndex ].getField)( lineIndex, work ) ) {
+        diagnose( Diagnostic::UNKNOWN_FIELD_VALUE, (int)(lineIndex + offset), csvField[ fieldIndex ].fieldName,
+                  "Channel %d, field '%s': Unknown field value '%s'",
+                  (int)(lineIndex + offset), csvField[ fieldIndex ].fieldName, work );
+        errors++;
+      }
+      switch ( column.type ) {
+        case BOOL:
+          if ( stricmp( work, "On" ) == 0 ) {
+            column.pData[ row / 8 ] |= 1 << row % 8;
+          }
+          break;
+        case UINT32: {
+          Json::number( work, text );
+          uint32_t value = (uint32_t)strtoul( text, 0, 10 );
+          memcpy( & column.pData[ row * sizeof value ], & value, sizeof value );
+          break;
+        }
+        case FLOAT64: {
+          Json::number( work, text );
+          double value = strtod( text, 0 );
+          memcpy( & column.pData[ row * sizeof value ], & value, sizeof value );
+          break;
+        }
+        case FIXED: {
+          size_t length = unquote( work, text );
+          memcpy( & column.pData[ row * column.width ], text, length < column.width ? length : column.width );
+          break;
+        }
+        case DICTIONARY: {
+          size_t length = unquote( work, text ),
+                 entry  = 0;
+          for (  ;  entry < column.width;  entry++ ) {
+            if ( column.pOffsets[ entry + 1 ] - column.pOffsets[ entry ] == length
+                &&  memcmp( & column.pText[ column.pOffsets[ entry ] ], text, length ) == 0 ) {
+              break;
+            }
+          }
+          if ( entry == column.width ) {
+            memcpy( & column.pText[ column.textSize ], text, length );
+            column.textSize += length;
+            column.pOffsets[ ++column.width ] = (uint32_t)column.textSize;
+          }
+          assert( entry < 0x8000 );
+          int16_t index = (int16_t)entry;
+          memcpy( & column.pData[ row * sizeof index ], & index, sizeof index );
+          break;
+        }
+      }
+    }
+    row++;
+  }
+
+  FlatBuffer               flat( (uint8_t *)arena.allocate( 0x1000 + 0x200 * count ), 0x1000 + 0x200 * count );
+  ArrowWriter              writer( output, flat );
+  uint8_t const         ** ppBuffers    = (uint8_t const **)arena.allocate( 2 * count * sizeof (uint8_t *) );
+  size_t                 * pSizes       = (size_t         *)arena.allocate( 2 * count * sizeof (size_t)    );
+  ArrowWriter::Block     * pBlocks      = (ArrowWriter::Block *)arena.allocate( (count + 1) * sizeof (ArrowWriter::Block) );
+  size_t                   dictionaries = 0;
+
+  writer.write( "ARROW1", 6 );
+  putSchema( flat, putMessage( flat, HEADER_SCHEMA, 0 ), 2, csvField, pColumns, count );
+  writer.message( 0, 0, 0 );
+  for ( size_t fieldIndex = 0;  fieldIndex < count;  fieldIndex++ ) {
+    Column const & column = pColumns[ fieldIndex ];
+    if ( column.type == DICTIONARY ) {
+      ppBuffers[ 0 ] = 0;
+      pSizes[    0 ] = 0;                               // no validity bitmap
+      ppBuffers[ 1 ] = (uint8_t const *)column.pOffsets;
+      pSizes[    1 ] = (column.width + 1) * sizeof (uint32_t);
+      ppBuffers[ 2 ] = (uint8_t const *)column.pText;
+      pSizes[    2 ] = column.textSize;
+      FlatBuffer::Table message = putMessage( flat, HEADER_DICTIONARY, bodySize( pSizes, 3 ) );
+      FlatBuffer::Table batch   = flat.table( 2 );
+      flat.offset( message, 2, batch.table );
+      flat.scalar( batch, 0, fieldIndex, 8 );
+      putRecords( flat, batch, 1, column.width, 1, pSizes, 3 );
+      pBlocks[ dictionaries++ ] = writer.message( ppBuffers, pSizes, 3 );
+    }
+  }
+  for ( size_t fieldIndex = 0;  fieldIndex < count;  fieldIndex++ ) {
+    ppBuffers[ 2 * fieldIndex     ] = 0;
+    pSizes[    2 * fieldIndex     ] = 0;
+    ppBuffers[ 2 * fieldIndex + 1 ] = pColumns[ fieldIndex ].pData;
+    pSizes[    2 * fieldIndex + 1 ] = pColumns[ fieldIndex ].dataSize;
+  }
+  putRecords( flat, putMessage( flat, HEADER_RECORDS, bodySize( pSizes, 2 * count ) ), 2, rows, count, pSizes, 2 * count );
+  pBlocks[ dictionaries ] = writer.message( ppBuffers, pSizes, 2 * count );
+  writer.write( "\xFF\xFF\xFF\xFF\0\0\0\0", 8 );         // end of stream
+
+  FlatBuffer::Table footer = flat.table( 4 );
+  flat.scalar( footer, 0, METADATA_V5, 2 );
+  putSchema( flat, footer, 1, csvField, pColumns, count );
+  for ( size_t list = 0;  list < 2;  list++ ) {         // dictionaries, then the record batch
+    size_t first  = list ? dictionaries : 0,
+           blocks = list ? 1 : dictionaries,
+           vector = flat.vector( blocks, 24 );
+    flat.offset( footer, 2 + list, vector );
+    for ( size_t index = 0;  index < blocks;  index++ ) {
+      flat.put( vector + 4 + 24 * index,      pBlocks[ first + index ].offset,   8 );
+      flat.put( vector + 4 + 24 * index + 8,  pBlocks[ first + index ].metadata, 4 );
+      flat.put( vector + 4 + 24 * index + 16, pBlocks[ first + index ].body,     8 );
+    }
+  }
+  size_t          size;
+  uint8_t const * pFooter = flat.finish( size );
+  uint8_t         trailer[ 10 ] = { (uint8_t)size, (uint8_t)(size >> 8), (uint8_t)(size >> 16), (uint8_t)(size >> 24),
+                                    'A', 'R', 'R', 'O', 'W', '1' };
+  writer.write( pFooter, size );
+  output.write( trailer, sizeof trailer );
+
+  Stats::add( Stats::BYTES_OUT,    writer.getPosition() + sizeof trailer );
+  Stats::add( Stats::CHANNELS,     rows   );
+  Stats::add( Stats::FIELDS,       rows * (count - 1) );
+  Stats::add( Stats::PARSE_ERRORS, errors );
+  return true;
+}
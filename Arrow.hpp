@@ -0,0 +1,51 @@
+//==================================================================================================
+//  Arrow.hpp is the columnar (Arrow IPC) export class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Exports the channels as an Arrow IPC file (the "Feather V2" format), one
+//  record batch with a column per CSV header field, typed as the model types the
+//  field (Radio::getFieldType), whatever the channels hold:  On/Off as booleans;
+//  whole numbers of Hz (or counts) as uint32, other numbers as float64;  names &
+//  calls as fixed-size binary, as wide as the model's;  and other text as
+//  dictionary-encoded (int16 indices) UTF-8.  No column has nulls.  The
+//  flatbuffer metadata is written here, front to back, with no dependencies;
+//  the buffers are 8-byte aligned, so readers can memory-map the file.
+
+#ifndef ARROW_HPP
+#define ARROW_HPP
+
+#include "Radio.hpp"
+
+class Arrow {
+  Arrow(             void              );  // Intentionally not implemented
+  Arrow(             Arrow const & rhs );  // Intentionally not implemented
+  Arrow & operator=( Arrow const & rhs );  // Intentionally not implemented
+
+ public:
+  enum Type {
+    BOOL,
+    UINT32,
+    FLOAT64,
+    FIXED,                // fixed-size binary
+    DICTIONARY            // of UTF-8
+  };
+
+  static bool dump( Radio const * pRadio, Output & output, uint8_t const * pSelect = 0,
+                    CsvField const * pPlan = 0 );   // see Radio::dump
+};
+
+#endif
@@ -0,0 +1,248 @@
+//==================================================================================================
+//  AsyncIo.cpp is the batched file I/O class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#include "AsyncIo.hpp"
+
+#ifdef  _WIN32
+
+AsyncIo * AsyncIo::create( size_t depth ) {
+  return 0;
+}
+
+#else
+
+#include <errno.h>
+#include <unistd.h>
+
+static void transfer( AsyncIo::Request * pRequest ) {   // blocking pread() or pwrite()
+  ssize_t result;
+  do {
+    result = pRequest->isWrite ? pwrite( pRequest->file, pRequest->pBuffer, pRequest->size, pRequest->offset )
+                               : pread(  pRequest->file, pRequest->pBuffer, pRequest->size, pRequest->offset );
+  } while ( result < 0  &&  errno == EINTR );
+  pRequest->result = result < 0 ? -errno : (long)result;
+}
+
+class PlainAsyncIo : public AsyncIo {   // each request completes as it is submitted
+  Request ** const ppDone;
+  size_t     const depth;
+  size_t           head,
+                   count;
+  PlainAsyncIo(             void                );  // Intentionally not implemented
+  PlainAsyncIo(             PlainAsyncIo const & rhs );  // Intentionally not implemented
+  PlainAsyncIo & operator=( PlainAsyncIo const & rhs );  // Intentionally not implemented
+
+ public:
+  PlainAsyncIo( size_t depth ) : ppDone( new Request *[ depth ] ), depth( depth ), head( 0 ), count( 0 ) {}
+  virtual ~PlainAsyncIo( void ) {
+    delete[] ppDone;
+  }
+  virtual char const * getName( void ) const {
+    return "pread";
+  }
+  virtual bool submit( Request * pRequest ) {
+    if ( count == depth ) {
+      return false;
+    }
+    transfer( pRequest );
+    ppDone[ (head + count++) % depth ] = pRequest;
+    return true;
+  }
+  virtual Request * wait( void ) {
+    if ( count == 0 ) {
+      return 0;
+    }
+    Request * pRequest = ppDone[ head ];
+    head = (head + 1) % depth;
+    count--;
+    return pRequest;
+  }
+};
+
+#if defined( __linux__ )  &&  defined( __has_include )
+# if __has_include( <linux/io_uring.h> )
+#  define USE_IO_URING
+# endif
+#endif
+
+#ifdef  USE_IO_URING
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+class UringAsyncIo : public AsyncIo {   // the submission & completion rings, mapped from the kernel
+  long                   ring;
+  unsigned             * pSqHead,
+                       * pSqTail,
+                       * pSqMask,
+                       * pSqArray,
+                       * pCqHead,
+                       * pCqTail,
+                       * pCqMask;
+  struct io_uring_sqe  * pSqes;
+  struct io_uring_cqe  * pCqes;
+  void                 * pSqRing,
+                       * pCqRing;
+  size_t                 sqRingSize,
+                         cqRingSize,
+                         sqesSize,
+                         depth,
+                         inFlight,   // submitted to the ring, not yet reaped
+                         pending;    // in the ring, not yet given to the kernel
+  UringAsyncIo(             UringAsyncIo const & rhs );  // Intentionally not implemented
+  UringAsyncIo & operator=( UringAsyncIo const & rhs );  // Intentionally not implemented
+
+ public:
+  UringAsyncIo( void ) : ring( -1 ), pSqes( (io_uring_sqe *)MAP_FAILED ), pSqRing( MAP_FAILED ), pCqRing( MAP_FAILED ),
+                    inFlight( 0 ), pending( 0 ) {}
+  virtual ~UringAsyncIo( void ) {
+    if ( pSqes   != MAP_FAILED ) {
+      munmap( pSqes,   sqesSize   );
+    }
+    if ( pCqRing != MAP_FAILED  &&  pCqRing != pSqRing ) {
+      munmap( pCqRing, cqRingSize );
+    }
+    if ( pSqRing != MAP_FAILED ) {
+      munmap( pSqRing, sqRingSize );
+    }
+    if ( ring >= 0 ) {
+      close( (int)ring );
+    }
+  }
+
+  bool open( size_t depth ) {
+    struct io_uring_params params;
+    memset( & params, 0, sizeof params );
+    ring = syscall( __NR_io_uring_setup, (unsigned)depth, & params );
+    if ( ring < 0 ) {
+      return false;
+    }
+    if ( !isSupported() ) {
+      return false;
+    }
+    this->depth = params.sq_entries;
+    sqRingSize  = params.sq_off.array + params.sq_entries * sizeof( unsigned );
+    cqRingSize  = params.cq_off.cqes  + params.cq_entries * sizeof( struct io_uring_cqe );
+    if ( params.features & IORING_FEAT_SINGLE_MMAP ) {
+      sqRingSize = cqRingSize = sqRingSize > cqRingSize ? sqRingSize : cqRingSize;
+    }
+    pSqRing = mmap( 0, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, (int)ring, IORING_OFF_SQ_RING );
+    if ( pSqRing == MAP_FAILED ) {
+      return false;
+    }
+    pCqRing = params.features & IORING_FEAT_SINGLE_MMAP ? pSqRing
+            : mmap( 0, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, (int)ring, IORING_OFF_CQ_RING );
+    if ( pCqRing == MAP_FAILED ) {
+      return false;
+    }
+    sqesSize = params.sq_entries * sizeof( struct io_uring_sqe );
+    pSqes    = (struct io_uring_sqe *)mmap( 0, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                            (int)ring, IORING_OFF_SQES );
+    if ( pSqes == MAP_FAILED ) {
+      return false;
+    }
+    pSqHead  = (unsigned *)((char *)pSqRing + params.sq_off.head        );
+    pSqTail  = (unsigned *)((char *)pSqRing + params.sq_off.tail        );
+    pSqMask  = (unsigned *)((char *)pSqRing + params.sq_off.ring_mask   );
+    pSqArray = (unsigned *)((char *)pSqRing + params.sq_off.array       );
+    pCqHead  = (unsigned *)((char *)pCqRing + params.cq_off.head        );
+    pCqTail  = (unsigned *)((char *)pCqRing + params.cq_off.tail        );
+    pCqMask  = (unsigned *)((char *)pCqRing + params.cq_off.ring_mask   );
+    pCqes    = (struct io_uring_cqe *)((char *)pCqRing + params.cq_off.cqes );
+    return true;
+  }
+
+  bool isSupported( void ) const {   // IORING_OP_READ & _WRITE are Linux 5.6+, as is the probe
+    size_t                   size   = sizeof (struct io_uring_probe) + IORING_OP_LAST * sizeof (struct io_uring_probe_op);
+    struct io_uring_probe  * pProbe = (struct io_uring_probe *)calloc( 1, size );
+    bool                     isOk   = pProbe != 0
+        &&  syscall( __NR_io_uring_register, (int)ring, IORING_REGISTER_PROBE, pProbe, (unsigned)IORING_OP_LAST ) >= 0
+        &&  pProbe->last_op >= IORING_OP_READ   &&  (pProbe->ops[ IORING_OP_READ  ].flags & IO_URING_OP_SUPPORTED)
+        &&  pProbe->last_op >= IORING_OP_WRITE  &&  (pProbe->ops[ IORING_OP_WRITE ].flags & IO_URING_OP_SUPPORTED);
+    free( pProbe );
+    return isOk;
+  }
+
+  virtual char const * getName( void ) const {
+    return "io_uring";
+  }
+
+  virtual bool submit( Request * pRequest ) {
+    if ( inFlight == depth ) {
+      return false;
+    }
+    unsigned tail  = *pSqTail;
+    unsigned index = tail & *pSqMask;
+    struct io_uring_sqe * pSqe = & pSqes[ index ];
+    memset( pSqe, 0, sizeof *pSqe );
+    pSqe->opcode    = pRequest->isWrite ? IORING_OP_WRITE : IORING_OP_READ;
+    pSqe->fd        = pRequest->file;
+    pSqe->addr      = (uint64_t)(uintptr_t)pRequest->pBuffer;
+    pSqe->len       = (uint32_t)pRequest->size;
+    pSqe->off       = pRequest->offset;
+    pSqe->user_data = (uint64_t)(uintptr_t)pRequest;
+    pSqArray[ index ] = index;
+    ATOMIC_STORE( *pSqTail, tail + 1 );
+    inFlight++;
+    pending++;
+    return true;
+  }
+
+  virtual Request * wait( void ) {
+    if ( inFlight == 0 ) {
+      return 0;
+    }
+    unsigned head = *pCqHead;
+    while ( head == ATOMIC_LOAD( *pCqTail ) ) {   // submit the batch & wait for one
+      long result = syscall( __NR_io_uring_enter, (int)ring, (unsigned)pending, 1U, IORING_ENTER_GETEVENTS, 0, 0 );
+      if ( result < 0 ) {
+        if ( errno != EINTR  &&  errno != EAGAIN  &&  errno != EBUSY ) {
+          fprintf( stderr, "*** io_uring_enter failed (%s) ***\n", strerror( errno ) );
+          abort();
+        }
+      } else {
+        pending -= (size_t)result;
+      }
+    }
+    struct io_uring_cqe * pCqe     = & pCqes[ head & *pCqMask ];
+    Request             * pRequest = (Request *)(uintptr_t)pCqe->user_data;
+    pRequest->result = pCqe->res;
+    if ( pRequest->result == -EINVAL ) {   // the kernel refused the operation;  do it the plain way
+      transfer( pRequest );
+    }
+    ATOMIC_STORE( *pCqHead, head + 1 );
+    inFlight--;
+    return pRequest;
+  }
+};
+
+#endif
+
+AsyncIo * AsyncIo::create( size_t depth ) {
+#ifdef  USE_IO_URING
+  UringAsyncIo * pIo = new UringAsyncIo;
+  if ( pIo->open( depth ) ) {
+    return pIo;
+  }
+  delete pIo;
+#endif
+  return new PlainAsyncIo( depth );
+}
+
+#endif
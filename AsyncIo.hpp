@@ -0,0 +1,56 @@
+//==================================================================================================
+//  AsyncIo.hpp is the batched file I/O class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Positioned reads & writes kept in flight together, completing in any order.
+//  On Linux with io_uring, requests are queued to the kernel and submitted in
+//  batches;  elsewhere (or when the kernel refuses io_uring), each request is
+//  done with a blocking pread()/pwrite() when submitted.  Not on Windows.
+
+#ifndef ASYNCIO_HPP
+#define ASYNCIO_HPP
+
+#include "Radio.hpp"
+
+class AsyncIo {
+  AsyncIo(             AsyncIo const & rhs );  // Intentionally not implemented
+  AsyncIo & operator=( AsyncIo const & rhs );  // Intentionally not implemented
+
+ protected:
+  AsyncIo( void ) {}
+
+ public:
+  struct Request {
+    void     * pBuffer;
+    size_t     size;
+    uint64_t   offset;
+    void     * pUser;     // the caller's
+    long       result;    // bytes transferred, or -errno
+    int        file;
+    bool       isWrite;
+    uint8_t    fill[ 3 ];
+  };
+
+  virtual            ~AsyncIo( void                ) {}
+  virtual char const * getName(  void                ) const = 0;
+  virtual bool         submit(   Request * pRequest  )       = 0;  // false if "depth" are in flight
+  virtual Request    * wait(     void                )       = 0;  // a completed request;  0 if none in flight
+
+  static  AsyncIo    * create(   size_t    depth     );            // io_uring if available
+};
+
+#endif
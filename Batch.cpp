@@ -0,0 +1,297 @@
+//==================================================================================================
+//  Batch.cpp is the batch conversion class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#include "Batch.hpp"
+#include "AsyncIo.hpp"
+#include "Library.hpp"
+#include "Queue.hpp"
+#include "Stats.hpp"
+
+#ifdef  _WIN32
+
+bool Batch::run( char const * pDirectory, size_t count, char const * const * ppNames ) {
+  fprintf( stderr, "*** --batch is not available on Windows ***\n" );
+  return false;
+}
+
+#else
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct Job {              // one file in progress;  its buffers are reused by the next
+  AsyncIo::Request   request;
+  MemoryOutput       csv;
+  char const       * pName;
+  uint8_t          * pImage;
+  size_t             limit,   // bytes allocated for pImage
+                     size,    // of the file
+                     done;    // bytes read, or written
+  uint64_t           started; // the read or write, for its Stats span
+  int                file;
+  bool               isBinary;
+  uint8_t            fill[ 3 ];
+};
+
+static void report( char const * pName, Library::Result const & result ) {
+  for ( size_t index = 0;  index < result.count  &&  index < Library::DIAGNOSTICS;  index++ ) {
+    fprintf( stderr, "*** %s: %s ***\n", pName, result.diagnostics[ index ].message );
+  }
+}
+
+static bool startRead( AsyncIo * pIo, Job * pJob, char const * pName ) {
+  struct stat info;
+  pJob->pName = pName;
+  pJob->file  = open( pName, O_RDONLY );
+  if ( pJob->file < 0 ) {
+    fprintf( stderr, "*** File not found: '%s' ***\n", pName );
+    return false;
+  }
+  if ( fstat( pJob->file, & info ) != 0  ||  (uint64_t)info.st_size > 4 * (uint64_t)Radio::MAX_IMAGE ) {
+    fprintf( stderr, "*** %s: Input file too large ***\n", pName );
+    close( pJob->file );
+    return false;
+  }
+  pJob->isBinary = isBinaryName( pName );
+  pJob->size     = (size_t)info.st_size;
+  pJob->done     = 0;
+  if ( pJob->size > pJob->limit ) {
+    free( pJob->pImage );
+    pJob->pImage = (uint8_t *)malloc( pJob->size );
+    pJob->limit  = pJob->pImage ? pJob->size : 0;
+    if ( pJob->pImage == 0 ) {
+      fprintf( stderr, "*** %s: Read error (%s) ***\n", pName, strerror( ENOMEM ) );
+      close( pJob->file );
+      return false;
+    }
+  }
+  pJob->started         = Stats::isEnabled ? Stats::now() : 0;
+  pJob->request.pBuffer = pJob->pImage;
+  pJob->request.size    = pJob->size;
+  pJob->request.offset  = 0;
+  pJob->request.pUser   = pJob;
+  pJob->request.file    = pJob->file;
+  pJob->request.isWrite = false;
+  return pIo->submit( & pJob->request );
+}
+
+static bool convert( Pool & pool, Job * pJob ) {   // the image to CSV
+  Library::Result result;
+  Radio * pRadio = Library::create( pJob->pImage, pJob->done, pJob->isBinary, & result, & pool );
+  report( pJob->pName, result );
+  if ( pRadio == 0 ) {
+    return false;
+  }
+  pJob->csv.clear();
+  Library::exportCsv( pRadio, pJob->csv, & result );
+  report( pJob->pName, result );
+  pool.release( pRadio );
+  if ( !pJob->csv.isComplete() ) {
+    fprintf( stderr, "*** %s: Out of memory for the CSV ***\n", pJob->pName );
+    return false;
+  }
+  return true;
+}
+
+static bool startWrite( AsyncIo * pIo, Job * pJob, char const * pDirectory ) {
+  char         path[ 4096 ];
+  char const * pBase = strrchr( pJob->pName, '/' );
+  pBase = pBase ? pBase + 1 : pJob->pName;
+  if ( snprintf( path, sizeof path, "%s/%s.csv", pDirectory, pBase ) >= (int)sizeof path ) {
+    fprintf( stderr, "*** %s: Output path too long ***\n", pJob->pName );
+    return false;
+  }
+  pJob->file = open( path, O_WRONLY | O_CREAT | O_TRUNC, 0666 );
+  if ( pJob->file < 0 ) {
+    fprintf( stderr, "*** Unable to write file: '%s' ***\n", path );
+    return false;
+  }
+  pJob->size            = pJob->csv.getSize();
+  pJob->done            = 0;
+  pJob->started         = Stats::isEnabled ? Stats::now() : 0;
+  pJob->request.pBuffer = (void *)pJob->csv.getData();
+  pJob->request.size    = pJob->size;
+  pJob->request.offset  = 0;
+  pJob->request.file    = pJob->file;
+  pJob->request.isWrite = true;
+  return pIo->submit( & pJob->request );
+}
+
+struct Pipeline {          // shared by the stages
+  Queue          freeJobs,    // reader <- converters & writer
+                 toConvert,   // reader -> converters
+                 toWrite;     // converters -> writer
+  char const   * pDirectory;
+  size_t         converters,
+                 converted,
+                 failed;
+  Job            end;         // pushed once per converter when the input is exhausted
+  Pipeline( size_t converters )
+      : freeJobs( Batch::DEPTH ), toConvert( Batch::DEPTH + converters ), toWrite( Batch::DEPTH + converters ),
+        pDirectory( 0 ), converters( converters ), converted( 0 ), failed( 0 ) {}
+};
+
+static void retire( Pipeline * pPipeline, Job * pJob, bool isOk ) {
+  ATOMIC_ADD( *(isOk ? & pPipeline->converted : & pPipeline->failed), 1 );
+  pPipeline->freeJobs.push( pJob );
+}
+
+static bool advance( AsyncIo * pIo, AsyncIo::Request * pRequest, bool & isOk ) {   // true when done
+  Job * pJob = (Job *)pRequest->pUser;
+  isOk = pRequest->result >= 0;
+  if ( !isOk ) {
+    fprintf( stderr, "*** %s: %s error (%s) ***\n", pJob->pName, pRequest->isWrite ? "Write" : "Read",
+                     strerror( (int)-pRequest->result ) );
+  } else if ( pRequest->result > 0  &&  (pJob->done += pRequest->result) < pJob->size ) {
+    pRequest->pBuffer = (char *)pRequest->pBuffer + pRequest->result;   // short transfer;  continue it
+    pRequest->size   -= pRequest->result;
+    pRequest->offset += pRequest->result;
+    isOk = pIo->submit( pRequest );
+    if ( isOk ) {
+      return false;
+    }
+  }
+  close( pJob->file );
+  Stats::setFile( pJob->pName );
+  Stats::endSpan( pRequest->isWrite ? Stats::WRITE : Stats::READ, pJob->started );
+  return true;
+}
+
+static void * convertStage( void * pContext ) {   // decode, detect & dump, on one Pool
+  Pipeline * pPipeline = (Pipeline *)pContext;
+  Pool       pool;
+  for ( ;; ) {
+    Job * pJob = (Job *)pPipeline->toConvert.pop();
+    if ( pJob == & pPipeline->end ) {
+      break;
+    }
+    Stats::setFile( pJob->pName );
+    if ( convert( pool, pJob ) ) {
+      pPipeline->toWrite.push( pJob );
+      Stats::sample( Stats::WRITE_QUEUE, pPipeline->toWrite.depth() );
+    } else {
+      retire( pPipeline, pJob, false );
+    }
+  }
+  pPipeline->toWrite.push( & pPipeline->end );
+  return 0;
+}
+
+static void * writeStage( void * pContext ) {
+  Pipeline * pPipeline = (Pipeline *)pContext;
+  AsyncIo  * pIo       = AsyncIo::create( Batch::DEPTH );
+  size_t     ends      = 0,
+             inFlight  = 0;
+  for ( ;; ) {
+    while ( ends < pPipeline->converters ) {      // start every converted file;  wait only when idle
+      Job * pJob = (Job *)(inFlight ? pPipeline->toWrite.tryPop() : pPipeline->toWrite.pop());
+      if ( pJob == 0 ) {
+        break;
+      } else if ( pJob == & pPipeline->end ) {
+        ends++;
+      } else if ( startWrite( pIo, pJob, pPipeline->pDirectory ) ) {
+        inFlight++;
+      } else {
+        retire( pPipeline, pJob, false );
+      }
+    }
+    if ( inFlight == 0 ) {
+      break;
+    }
+    bool               isOk;
+    AsyncIo::Request * pRequest = pIo->wait();
+    if ( advance( pIo, pRequest, isOk ) ) {
+      inFlight--;
+      retire( pPipeline, (Job *)pRequest->pUser, isOk );
+    }
+  }
+  delete pIo;
+  return 0;
+}
+
+bool Batch::run( char const         * pDirectory,
+                 size_t               count,
+                 char const * const * ppNames ) {
+  long       processors = sysconf( _SC_NPROCESSORS_ONLN );
+  size_t     converters = processors < 1 ? 1 : processors > CONVERTERS ? (size_t)CONVERTERS : (size_t)processors,
+             next       = 0,
+             inFlight   = 0,
+             started    = 0;
+  Pipeline   pipeline( converters );
+  AsyncIo  * pIo        = AsyncIo::create( DEPTH );
+  Job        jobs[ DEPTH ];
+  pthread_t  threads[ CONVERTERS + 1 ];
+
+  pipeline.pDirectory = pDirectory;
+  for ( size_t index = 0;  index < DEPTH;  index++ ) {
+    jobs[ index ].pImage = 0;
+    jobs[ index ].limit  = 0;
+    pipeline.freeJobs.push( & jobs[ index ] );
+  }
+  for (  ;  started <= converters;  started++ ) {
+    if ( pthread_create( & threads[ started ], 0, started < converters ? convertStage : writeStage,
+                         & pipeline ) != 0 ) {
+      fprintf( stderr, "*** Unable to start batch thread ***\n" );
+      exit( 2 );          // a stage is missing, so the others would never finish
+    }
+  }
+  for ( ;; ) {            // this thread reads
+    while ( next < count ) {                      // start every free job;  wait only when idle
+      Job * pJob = (Job *)(inFlight ? pipeline.freeJobs.tryPop() : pipeline.freeJobs.pop());
+      if ( pJob == 0 ) {
+        break;
+      } else if ( startRead( pIo, pJob, ppNames[ next++ ] ) ) {
+        inFlight++;
+      } else {
+        retire( & pipeline, pJob, false );
+      }
+    }
+    if ( inFlight == 0 ) {
+      break;
+    }
+    bool               isOk;
+    AsyncIo::Request * pRequest = pIo->wait();
+    if ( advance( pIo, pRequest, isOk ) ) {
+      inFlight--;
+      if ( isOk ) {
+        pipeline.toConvert.push( pRequest->pUser );
+        Stats::sample( Stats::CONVERT_QUEUE, pipeline.toConvert.depth() );
+      } else {
+        retire( & pipeline, (Job *)pRequest->pUser, false );
+      }
+    }
+  }
+  for ( size_t index = 0;  index < converters;  index++ ) {
+    pipeline.toConvert.push( & pipeline.end );
+  }
+  for ( size_t index = 0;  index <= converters;  index++ ) {
+    pthread_join( threads[ index ], 0 );
+  }
+  for ( size_t index = 0;  index < DEPTH;  index++ ) {
+    free( jobs[ index ].pImage );
+  }
+  status( "--- Files: %d converted, %d failed (%s, %d converters) ---\n", (int)pipeline.converted,
+          (int)pipeline.failed, pIo->getName(), (int)converters );
+  delete pIo;
+  return pipeline.failed == 0;
+}
+
+#endif
@@ -0,0 +1,46 @@
+//==================================================================================================
+//  Batch.hpp is the batch conversion class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  "--batch" exports many radio files to CSV files in one directory, as a
+//  pipeline of stages joined by bounded Queues:  this thread reads, CONVERTERS
+//  (at most, one per processor) threads each decode, detect & dump, and one
+//  thread writes.  Reads & writes go through AsyncIo (io_uring where available),
+//  so I/O latency overlaps across files.  Only DEPTH files are in progress at
+//  once;  a stage that gets ahead waits for a free one, which caps memory.
+//  Not on Windows.
+
+#ifndef BATCH_HPP
+#define BATCH_HPP
+
+#include "Radio.hpp"
+
+class Batch {
+  Batch(             void              );  // Intentionally not implemented
+  Batch(             Batch const & rhs );  // Intentionally not implemented
+  Batch & operator=( Batch const & rhs );  // Intentionally not implemented
+
+ public:
+  enum {
+    DEPTH      = 32,      // files in progress
+    CONVERTERS = 8        // threads, at most
+  };
+
+  static bool run( char const * pDirectory, size_t count, char const * const * ppNames );
+};
+
+#endif
@@ -0,0 +1,117 @@
+//==================================================================================================
+//  Bench.cpp is the benchmark harness class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#include "Bench.hpp"
+#include "Stats.hpp"
+
+#include <time.h>
+
+enum Step {
+  stepCreate,
+  stepDump,
+  stepLoad,
+  stepSave,
+  stepCount
+};
+
+static char const * const stepNames[ stepCount ] = { "create", "dump", "load", "save" };
+
+bool Bench::run( char const * pModel,
+                 double       seconds ) {
+  FILE * pNull   = fopen( NULL_DEVICE, "w" );
+  bool   isFound = false;
+
+  if ( pNull == 0 ) {
+    fprintf( stderr, "*** Unable to write file: '%s' ***\n", NULL_DEVICE );
+    return false;
+  }
+  for ( size_t model = 0;  model < Generate::count();  model++ ) {
+    if ( pModel != 0  &&  stricmp( pModel, Generate::name( model ) ) != 0 ) {
+      continue;
+    }
+    if ( !isFound ) {
+      printf( "%-11s %-6s %8s %6s %7s %9s %11s\n", "Model", "Step", "Bytes", "Chans", "Runs", "MB/s", "Chans/s" );
+      isFound = true;
+    }
+
+    size_t  channels;
+    bool    isBinary = Generate::isBinary( model );
+    Stats::setFile( Generate::name( model ) );
+    Radio * pRadio   = Generate::image( model, SEED, & channels );
+    FILE  * pImage   = tmpfile();
+    FILE  * pCsv     = tmpfile();
+    if ( pRadio == 0  ||  pImage == 0  ||  pCsv == 0 ) {
+      fprintf( stderr, "*** Unable to generate %s image ***\n", Generate::name( model ) );
+      if ( pImage != 0 ) {
+        fclose( pImage );
+      }
+      if ( pCsv != 0 ) {
+        fclose( pCsv );
+      }
+      delete pRadio;
+      continue;
+    }
+    quietDepth++;
+    pRadio->save( pImage, isBinary, 0 );
+    pRadio->dump( pCsv );
+    long imageBytes = ftell( pImage ),
+         csvBytes   = ftell( pCsv   );
+
+    for ( int step = 0;  step < stepCount;  step++ ) {
+      long    runs  = 0;
+      clock_t start = clock(),
+              end;
+      do {
+        switch ( step ) {
+        case stepCreate:
+          rewind( pImage );
+          delete Radio::create( pImage, isBinary );
+          break;
+        case stepDump:
+          pRadio->dump( pNull );
+          break;
+        case stepLoad:
+          rewind( pCsv );
+          pRadio->load( pCsv );
+          break;
+        case stepSave:
+          pRadio->save( pNull, isBinary, 0 );
+          break;
+        }
+        runs++;
+        end = clock();
+      } while ( end - start < seconds * CLOCKS_PER_SEC );
+
+      double elapsed = (double)(end - start) / CLOCKS_PER_SEC;
+      long   bytes   = step == stepDump  ||  step == stepLoad ? csvBytes : imageBytes;
+      elapsed = elapsed > 0 ? elapsed : 1.0 / CLOCKS_PER_SEC;
+      printf( "%-11s %-6s %8ld %6d %7ld %9.2f %11.0f\n", Generate::name( model ), stepNames[ step ],
+              bytes, (int)channels, runs, runs * (bytes / 1000000.0) / elapsed, runs * channels / elapsed );
+      fflush( stdout );
+    }
+    quietDepth--;
+    fclose( pImage );
+    fclose( pCsv   );
+    delete pRadio;
+  }
+  fclose( pNull );
+  if ( !isFound ) {
+    fprintf( stderr, "*** Unknown model: '%s' ***\n", pModel );
+  }
+  return isFound;
+}
@@ -0,0 +1,41 @@
+//==================================================================================================
+//  Bench.hpp is the benchmark harness class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Times create (file parse), dump (CSV export), load (CSV import) & save
+//  (file write) on a generated image of each model, and reports MB/s of the
+//  stream each step reads or writes, and channels/s.  CPU time is measured.
+
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+#include "Generate.hpp"
+
+class Bench {
+  Bench(             void              );  // Intentionally not implemented
+  Bench(             Bench const & rhs );  // Intentionally not implemented
+  Bench & operator=( Bench const & rhs );  // Intentionally not implemented
+
+ public:
+  enum {
+    SEED = 1              // every run benchmarks the same images
+  };
+
+  static bool run( char const * pModel, double seconds );
+};
+
+#endif
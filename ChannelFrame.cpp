@@ -0,0 +1,461 @@
+//==================================================================================================
+//  ChannelFrame.cpp is the columnar channel class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#include "ChannelFrame.hpp"
+#include "Dstar.hpp"
+#include "Stats.hpp"
+
+#define MEANING( CLASS, FIELD, COLUMN )  { reinterpret_cast< getField_t >( & CLASS::_get##FIELD ), COLUMN }
+
+ChannelFrame::Meaning const ChannelFrame::meanings[]
+    = { MEANING( Radio, RxFreq,       RX_HZ            ),
+        MEANING( Radio, TxFreq,       TX_HZ            ),
+        MEANING( Radio, TxOffset,     TX_OFFSET_HZ     ),
+        MEANING( Radio, Split,        SPLIT            ),
+        MEANING( Radio, RxStep,       RX_STEP_HZ       ),
+        MEANING( Radio, TxStep,       TX_STEP_HZ       ),
+        MEANING( Radio, Modulation,   MODULATION       ),
+        MEANING( Radio, Filter,       FILTER           ),
+        MEANING( Dstar, SkipMode,     SKIP_MODE        ),
+        MEANING( Radio, FmSquelch,    FM_SQUELCH       ),
+        MEANING( Radio, CtcssEncode,  CTCSS_ENCODE_DHZ ),
+        MEANING( Radio, CtcssDecode,  CTCSS_DECODE_DHZ ),
+        MEANING( Radio, DcsCode,      DCS_CODE         ),
+        MEANING( Radio, DcsReverse,   DCS_REVERSE      ),
+        MEANING( Dstar, DvSquelch,    DV_SQUELCH       ),
+        MEANING( Dstar, DvCsqlCode,   DV_CSQL_CODE     ),
+        MEANING( Dstar, BankGroup,    BANK_GROUP       ),
+        MEANING( Dstar, BankChannel,  BANK_CHANNEL     ),
+        MEANING( Radio, Name,         NAME             ),
+        MEANING( Dstar, YourCall,     YOUR_CALL        ),
+        MEANING( Dstar, Rpt1Call,     RPT1_CALL        ),
+        MEANING( Dstar, Rpt2Call,     RPT2_CALL        ) };
+
+ChannelFrame::ChannelFrame( void ) : rows( 0 ), nameSize( 0 ), columns( 0 ), pChannels( 0 ) {
+  memset( pData,       0, sizeof pData       );
+  memset( ppLabels,    0, sizeof ppLabels    );
+  memset( labelCounts, 0, sizeof labelCounts );
+}
+
+static bool isDstar( ChannelFrame::Column column ) {
+  return column == ChannelFrame::SKIP_MODE
+      || (column >= ChannelFrame::DV_SQUELCH  &&  column <= ChannelFrame::BANK_CHANNEL)
+      ||  column >  ChannelFrame::NAME;
+}
+
+static uint32_t scaled( double const * pTable, size_t count, size_t code, double scale ) {
+  if ( code >= count ) {
+    return ChannelFrame::UNKNOWN;
+  }
+  double value = pTable[ code ] * scale;          // a few models have negative steps
+  return (uint32_t)(int32_t)(value < 0 ? value - 0.5 : value + 0.5);
+}
+
+int ChannelFrame::columnOf( getField_t getField ) {
+  for ( size_t index = 0;  index < COUNT_OF( meanings );  index++ ) {
+    if ( getField == meanings[ index ].getField ) {
+      return (int)meanings[ index ].column;
+    }
+  }
+  return -1;
+}
+
+char const * const * ChannelFrame::labelsOf( Radio const * pRadio,
+                                            Column        column,
+                                            size_t      * pCount ) {
+  *pCount = 0;
+  switch ( column ) {
+    case SPLIT:        return pRadio->getSplits(      pCount );
+    case MODULATION:   return pRadio->getModulations( pCount );
+    case FM_SQUELCH:   return pRadio->getFmSquelches( pCount );
+    case DCS_REVERSE:  return pRadio->getDcsReverses( pCount );
+    case DV_SQUELCH:   return static_cast< Dstar const * >( pRadio )->getDvSquelches( pCount );
+    default:           return 0;
+  }
+}
+
+uint32_t ChannelFrame::columnsOf( Radio const * pRadio,
+                                  size_t      * pOrder,
+                                  size_t      * pColumns ) {
+  CsvField const * const csvField = pRadio->csvHeader();
+  uint32_t               present  = 0;
+  size_t                 columns  = 0;
+  for ( size_t fieldIndex = 1;  csvField[ fieldIndex ].fieldName != 0;  fieldIndex++ ) {
+    for ( size_t index = 0;  index < COUNT_OF( meanings );  index++ ) {
+      if ( csvField[ fieldIndex ].getField == meanings[ index ].getField ) {
+        if ( (present & 1 << meanings[ index ].column) == 0  &&  pRadio->isTyped( meanings[ index ].getField ) ) {
+          present |= 1 << meanings[ index ].column;
+          if ( pOrder != 0 ) {
+            pOrder[ columns ] = meanings[ index ].column;
+          }
+          columns++;
+        }
+        break;
+      }
+    }
+  }
+  if ( pColumns != 0 ) {
+    *pColumns = columns;
+  }
+  return present;
+}
+
+uint32_t ChannelFrame::getCell( Radio const * pRadio,
+                                size_t        index,
+                                Column        column,
+                                char        * pText ) {
+  Dstar    const * pDstar = static_cast< Dstar const * >( isDstar( column ) ? pRadio : 0 );
+  size_t           count;
+  uint16_t const * pCodes;
+  switch ( column ) {
+    case RX_HZ:             return pRadio->getRxFreq(     index );
+    case TX_HZ:             return pRadio->getTxFreq(     index );
+    case TX_OFFSET_HZ:      return pRadio->getTxOffset(   index );
+    case SPLIT:             return pRadio->getSplit(      index );
+    case MODULATION:        return pRadio->getModulation( index );
+    case FILTER:            return pRadio->getFilter(     index );
+    case SKIP_MODE:         return pDstar->getSkipMode(   index );
+    case FM_SQUELCH:        return pRadio->getFmSquelch(  index );
+    case DCS_REVERSE:       return pRadio->getDcsReverse( index );
+    case DV_SQUELCH:        return pDstar->getDvSquelch(  index );
+    case DV_CSQL_CODE:      return pDstar->getDvCsqlCode( index );
+    case BANK_GROUP:        return pDstar->getBankGroup(  index );
+    case BANK_CHANNEL:      return pDstar->getBankChannel( index );
+    case RX_STEP_HZ:
+    case TX_STEP_HZ: {
+      double const * pTable = pRadio->getTuneSteps( & count );
+      return scaled( pTable, count, column == RX_STEP_HZ ? pRadio->getRxStep( index ) : pRadio->getTxStep( index ), 1000 );
+    }
+    case CTCSS_ENCODE_DHZ:
+    case CTCSS_DECODE_DHZ: {
+      double const * pTable = pRadio->getCtcssCodes( & count );
+      return scaled( pTable, count, column == CTCSS_ENCODE_DHZ ? pRadio->getCtcssEncode( index )
+                                                               : pRadio->getCtcssDecode( index ), 10 );
+    }
+    case DCS_CODE: {
+      size_t code = pRadio->getDcsCode( index );
+      pCodes = pRadio->getDcsCodes( & count );
+      return code < count ? pCodes[ code ] : (uint32_t)UNKNOWN;
+    }
+    case NAME: {
+      size_t       size;
+      char const * pName = pRadio->getName( index, & size );
+      size = size < NAME_SIZE ? size : (size_t)NAME_SIZE;
+      memset( pText, ' ', NAME_SIZE );
+      memcpy( pText, pName, strnlen( pName, size ) );
+      return (uint32_t)size;
+    }
+    case YOUR_CALL:
+      memcpy( pText, pDstar->getYourCall( index ).callsign, CALL_SIZE );
+      return CALL_SIZE;
+    case RPT1_CALL:
+      memcpy( pText, pDstar->getRpt1Call( index ).callsign, CALL_SIZE );
+      return CALL_SIZE;
+    case RPT2_CALL:
+      memcpy( pText, pDstar->getRpt2Call( index ).callsign, CALL_SIZE );
+      return CALL_SIZE;
+    case COLUMNS:
+      break;
+  }
+  return UNKNOWN;
+}
+
+bool ChannelFrame::setCell( Radio      * pRadio,
+                            size_t       index,
+                            Column       column,
+                            uint32_t     value,
+                            char const * pText ) {
+  Dstar          * pDstar = static_cast< Dstar * >( isDstar( column ) ? pRadio : 0 );
+  size_t           count;
+  double   const * pTable;
+  uint16_t const * pCodes;
+  int              code;
+  switch ( column ) {
+    case RX_HZ:             return pRadio->setRxFreq(      index, value );
+    case TX_HZ:             return pRadio->setTxFreq(      index, value );
+    case TX_OFFSET_HZ:      return pRadio->setTxOffset(    index, value );
+    case SPLIT:             return pRadio->setSplit(       index, value );
+    case MODULATION:        return pRadio->setModulation(  index, value );
+    case FILTER:            return pRadio->setFilter(      index, value );
+    case SKIP_MODE:         return pDstar->setSkipMode(    index, value );
+    case FM_SQUELCH:        return pRadio->setFmSquelch(   index, value );
+    case DCS_REVERSE:       return pRadio->setDcsReverse(  index, value );
+    case DV_SQUELCH:        return pDstar->setDvSquelch(   index, value );
+    case DV_CSQL_CODE:      return pDstar->setDvCsqlCode(  index, value );
+    case BANK_GROUP:        return pDstar->setBankGroup(   index, value );
+    case BANK_CHANNEL:      return pDstar->setBankChannel( index, value );
+    case RX_STEP_HZ:
+    case TX_STEP_HZ:
+      pTable = pRadio->getTuneSteps( & count );
+      code   = search( (int32_t)value / 1000.0, pTable, count, 0.005 );
+      return code >= 0  &&  (column == RX_STEP_HZ ? pRadio->setRxStep( index, code )
+                                                  : pRadio->setTxStep( index, code ));
+    case CTCSS_ENCODE_DHZ:
+    case CTCSS_DECODE_DHZ:
+      pTable = pRadio->getCtcssCodes( & count );
+      code   = search( value / 10.0, pTable, count, 0.05 );
+      return code >= 0  &&  (column == CTCSS_ENCODE_DHZ ? pRadio->setCtcssEncode( index, code )
+                                                        : pRadio->setCtcssDecode( index, code ));
+    case DCS_CODE:
+      pCodes = pRadio->getDcsCodes( & count );
+      code   = value <= 0xFFFF ? search( (uint16_t)value, pCodes, count ) : -1;
+      return code >= 0  &&  pRadio->setDcsCode( index, code );
+    case NAME:              return pRadio->setName(        index, pText );
+    case YOUR_CALL:         return pDstar->setYourCall(    index, pText );
+    case RPT1_CALL:         return pDstar->setRpt1Call(    index, pText );
+    case RPT2_CALL:         return pDstar->setRpt2Call(    index, pText );
+    case COLUMNS:
+      break;
+  }
+  return false;
+}
+
+void ChannelFrame::decode( Radio const * pRadio ) {
+  Stats::Span span( Stats::DUMP );
+  decode( pRadio, ~(uint32_t)0 );
+  Stats::add( Stats::CHANNELS, rows );
+  Stats::add( Stats::FIELDS,   rows * columns );
+}
+
+void ChannelFrame::decode( Radio const * pRadio,
+                           uint32_t      wanted ) {
+  size_t const offset = pRadio->getOffset();
+  size_t       all;
+
+  arena.reset();
+  memset( pData,       0, sizeof pData       );
+  memset( ppLabels,    0, sizeof ppLabels    );
+  memset( labelCounts, 0, sizeof labelCounts );
+  columnsOf( pRadio, order, & all );
+  columns = 0;
+  for ( size_t which = 0;  which < all;  which++ ) {
+    if ( (wanted & 1 << order[ which ]) != 0 ) {
+      order[ columns++ ] = order[ which ];
+    }
+  }
+  rows     = 0;
+  nameSize = 0;
+  for ( size_t index = 0;  index < pRadio->getCount();  index++ ) {
+    rows += pRadio->getValid( index );
+  }
+  pChannels = (uint32_t *)arena.allocate( (rows + 1) * sizeof (uint32_t) );
+  for ( size_t index = 0, row = 0;  index < pRadio->getCount();  index++ ) {
+    if ( pRadio->getValid( index ) ) {
+      pChannels[ row++ ] = (uint32_t)(index + offset);
+    }
+  }
+
+  for ( size_t which = 0;  which < columns;  which++ ) {     // a column at a time
+    Column     column  = (Column)order[ which ];
+    size_t     width   = column == NAME ? (size_t)NAME_SIZE : column > NAME ? (size_t)CALL_SIZE : sizeof (uint32_t);
+    uint32_t * pValues = (uint32_t *)arena.allocate( rows * width + 1 );
+    char     * pText   = (char     *)pValues;
+    pData[ column ] = pValues;
+    if ( column < NAME ) {
+      for ( size_t row = 0;  row < rows;  row++ ) {
+        pValues[ row ] = getCell( pRadio, pChannels[ row ] - offset, column, 0 );
+      }
+    } else {
+      char work[ NAME_SIZE ];
+      for ( size_t row = 0;  row < rows;  row++ ) {
+        size_t size = getCell( pRadio, pChannels[ row ] - offset, column, work );
+        memcpy( & pText[ row * width ], work, width );
+        nameSize = column == NAME ? size : nameSize;
+      }
+    }
+    ppLabels[ column ] = labelsOf( pRadio, column, & labelCounts[ column ] );
+  }
+}
+
+bool ChannelFrame::encode( Radio * pRadio ) const {
+  Stats::Span  span( Stats::LOAD );
+  size_t const offset = pRadio->getOffset();
+  size_t       errors = 0;
+
+  for ( size_t row = 0;  row < rows;  row++ ) {
+    size_t index = pChannels[ row ] - offset;
+    if ( index >= pRadio->getCount() ) {
+      diagnose( Diagnostic::INVALID_CHANNEL, (int)pChannels[ row ], 0,
+                "Channel %d: Invalid number; row skipped", (int)pChannels[ row ] );
+      errors++;
+      continue;
+    }
+    if ( !pRadio->getValid( index ) ) {
+      pRadio->setValid( index, true );      // the model's defaults, for the fields not in the frame
+    }
+    for ( size_t which = 0;  which < columns;  which++ ) {   // in CSV order, as a load sets them
+      Column   column = (Column)order[ which ];
+      uint32_t value  = column < NAME ? ((uint32_t const *)pData[ column ])[ row ] : 0;
+      char     work[ NAME_SIZE + 1 ];
+      if ( value == UNKNOWN ) {
+        continue;         // as decoded;  left as it is
+      }
+      if ( column >= NAME ) {
+        size_t size = column == NAME ? nameSize : (size_t)CALL_SIZE;
+        memcpy( work, & ((char const *)pData[ column ])[ row * (column == NAME ? NAME_SIZE : CALL_SIZE) ], size );
+        work[ size ] = 0;
+      }
+      if ( !setCell( pRadio, index, column, value, work ) ) {
+        diagnose( Diagnostic::INVALID_FIELD, (int)pChannels[ row ], 0,
+                  "Channel %d, column %d: Invalid value %lu", (int)pChannels[ row ], (int)column, (unsigned long)value );
+        errors++;
+      }
+    }
+  }
+  Stats::add( Stats::CHANNELS,     rows   );
+  Stats::add( Stats::PARSE_ERRORS, errors );
+  return errors == 0;
+}
+
+void Radio::decode( ChannelFrame & frame ) const {
+  frame.decode( this );
+}
+
+bool Radio::encode( ChannelFrame const & frame ) {
+  return frame.encode( this );
+}
+
+uint32_t Radio::getPresent( void ) const {
+  if ( present == 0 ) {                     // once per Radio, not per create() or getChannel()
+    present = ChannelFrame::columnsOf( this, 0, 0 );
+  }
+  return present;
+}
+
+bool Radio::getChannel( size_t    channel,
+                        Channel & result ) const {
+  size_t index = channel - getOffset();
+  if ( index >= getCount()  ||  !getValid( index ) ) {
+    return false;
+  }
+  result.number  = (uint32_t)channel;
+  result.present = getPresent();
+  memset( result.name,  0, sizeof result.name  );
+  memset( result.calls, 0, sizeof result.calls );
+  for ( size_t column = 0;  column < Channel::COLUMNS;  column++ ) {
+    bool isPresent = (result.present & 1 << column) != 0;
+    if ( column < Channel::NAME ) {
+      result.values[ column ] = isPresent ? ChannelFrame::getCell( this, index, (Channel::Column)column, 0 )
+                                          : (uint32_t)Channel::UNKNOWN;
+    } else if ( isPresent ) {
+      char   work[ Channel::NAME_SIZE ];
+      size_t size = ChannelFrame::getCell( this, index, (Channel::Column)column, work );
+      memcpy( column == Channel::NAME ? result.name : result.calls[ column - Channel::YOUR_CALL ], work, size );
+    }
+  }
+  return true;
+}
+
+bool Radio::setField( size_t          channel,
+                      Channel::Column column,
+                      uint32_t        value ) {
+  size_t index = channel - getOffset();
+  if ( column >= Channel::NAME  ||  index >= getCount()
+      ||  (getPresent() & 1 << column) == 0 ) {
+    return false;
+  }
+  if ( !getValid( index ) ) {
+    setValid( index, true );
+  }
+  return ChannelFrame::setCell( this, index, column, value, 0 );
+}
+
+bool Radio::setText( size_t          channel,
+                     Channel::Column column,
+                     char const    * pText ) {
+  size_t index = channel - getOffset();
+  if ( column < Channel::NAME  ||  column >= Channel::COLUMNS  ||  index >= getCount()
+      ||  (getPresent() & 1 << column) == 0 ) {
+    return false;
+  }
+  if ( !getValid( index ) ) {
+    setValid( index, true );
+  }
+  return ChannelFrame::setCell( this, index, column, 0, pText );
+}
+
+size_t Radio::nextChannel( size_t channel ) const {
+  size_t const offset = getOffset();
+  for ( size_t index = channel < offset ? 0 : channel - offset;  index < getCount();  index++ ) {
+    if ( getValid( index ) ) {
+      return index + offset;
+    }
+  }
+  return (size_t)-1;
+}
+
+static CsvField::Type labelType( char const * const * ppLabels, size_t count ) {
+  for ( size_t index = 0;  index < count;  index++ ) {
+    if ( stricmp( ppLabels[ index ], "On" ) != 0  &&  stricmp( ppLabels[ index ], "Off" ) != 0 ) {
+      return CsvField::LABEL;
+    }
+  }
+  return count > 0 ? CsvField::ON_OFF : CsvField::LABEL;
+}
+
+CsvField::Type Radio::getFieldType( getField_t   getField,
+                                    size_t     * pWidth ) const {   // from the field's meaning & the model's tables
+  int            column = isTyped( getField ) ? ChannelFrame::columnOf( getField ) : -1;
+  size_t         count;
+  double const * pSteps;
+  *pWidth = 0;
+  switch ( column ) {
+    case Channel::RX_HZ:
+    case Channel::TX_HZ:
+    case Channel::TX_OFFSET_HZ:
+    case Channel::FILTER:
+    case Channel::DCS_CODE:
+    case Channel::DV_CSQL_CODE:
+    case Channel::BANK_CHANNEL:
+      return CsvField::WHOLE;
+    case Channel::CTCSS_ENCODE_DHZ:
+    case Channel::CTCSS_DECODE_DHZ:
+      return CsvField::DECIMAL;
+    case Channel::RX_STEP_HZ:
+    case Channel::TX_STEP_HZ:
+      pSteps = getTuneSteps( & count );
+      for ( size_t index = 0;  index < count;  index++ ) {
+        double hz    = pSteps[ index ] * 1000,
+               whole = hz < 0 ? 0 : (double)(uint32_t)(hz + 0.5);
+        if ( hz < 0  ||  hz - whole > 1e-6  ||  whole - hz > 1e-6 ) {   // negative or fractional Hz
+          return CsvField::DECIMAL;
+        }
+      }
+      return CsvField::WHOLE;
+    case Channel::SPLIT:
+    case Channel::MODULATION:
+    case Channel::FM_SQUELCH:
+    case Channel::DCS_REVERSE:
+    case Channel::DV_SQUELCH: {
+      char const * const * ppLabels = ChannelFrame::labelsOf( this, (Channel::Column)column, & count );
+      return labelType( ppLabels, count );
+    }
+    case Channel::SKIP_MODE:
+      return labelType( skipModes, COUNT_OF( skipModes ) );
+    case Channel::NAME:
+      getName( 0, pWidth );
+      return CsvField::TEXT;
+    case Channel::YOUR_CALL:
+    case Channel::RPT1_CALL:
+    case Channel::RPT2_CALL:
+      *pWidth = Channel::CALL_SIZE;
+      return CsvField::TEXT;
+    default:              // the bank letter, and the model's own fields
+      return CsvField::LABEL;
+  }
+}
@@ -0,0 +1,116 @@
+//==================================================================================================
+//  ChannelFrame.hpp is the columnar channel class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  The valid channels of any model, decoded into one contiguous column per
+//  meaning (structure of arrays), so that analysis, comparison & filtering can
+//  loop over a column instead of calling a virtual getter per field per row.
+//  A model has the columns whose CSV fields it has;  the others are absent
+//  (getValues() and getText() return 0).  Values are model-independent where
+//  the meaning allows:  frequencies & steps in Hz, CTCSS tones in tenths of a
+//  Hz, and DCS codes as their numbers (steps are signed:  a few models have
+//  negative placeholder steps).  Other enumerations (split, modulation,
+//  squelch, ...) keep the model's codes;  getLabels() gives the model's names
+//  for them.  An unknown value (one that the CSV reports as unknown) is UNKNOWN.
+//  Fields particular to one model (such as power level) are not decoded.
+//
+//  Radio::decode() fills a frame from the image, and Radio::encode() writes
+//  each frame row back to its channel;  a channel that was not valid starts
+//  from the model's defaults, as in a CSV load.  Other channels, and the fields
+//  not in the frame, are left as they are.  Both go column by column, through
+//  the model's typed getters & setters;  Radio::isTyped() leaves out a CSV
+//  field that a model formats some other way.
+
+#ifndef CHANNELFRAME_HPP
+#define CHANNELFRAME_HPP
+
+#include "Radio.hpp"
+
+class ChannelFrame : public ChannelColumns {
+  ChannelFrame(             ChannelFrame const & rhs );  // Intentionally not implemented
+  ChannelFrame & operator=( ChannelFrame const & rhs );  // Intentionally not implemented
+
+ public:
+  ChannelFrame( void );
+
+  size_t               getRows(     void          ) const {
+    return rows;
+  }
+  uint32_t     const * getChannels( void          ) const {   // each row's channel number, as in the CSV
+    return pChannels;
+  }
+  uint32_t           * getValues(   Column column )       {   // numeric columns
+    return column < NAME ? (uint32_t *)pData[ column ] : 0;
+  }
+  uint32_t     const * getValues(   Column column ) const {
+    return column < NAME ? (uint32_t const *)pData[ column ] : 0;
+  }
+  char               * getText(     Column column )       {   // text columns, space-padded
+    return column >= NAME ? (char *)pData[ column ] : 0;
+  }
+  char         const * getText(     Column column ) const {
+    return column >= NAME ? (char const *)pData[ column ] : 0;
+  }
+  size_t               getNameSize( void          ) const {   // the model's name length, up to NAME_SIZE
+    return nameSize;
+  }
+  char const * const * getLabels(   Column column, size_t * pCount ) const {   // 0 if none
+    *pCount = labelCounts[ column ];
+    return ppLabels[ column ];
+  }
+
+  static int                 columnOf( getField_t    getField );   // the Column of a CSV field, or -1 if none
+  static char const * const * labelsOf( Radio const * pRadio, Column column, size_t * pCount );  // 0 if none
+
+ private:
+  friend class Radio;
+  friend class Convert;
+  friend class Dedupe;
+  friend class Compact;
+  friend class Filter;
+  friend class Merge;
+  friend class Sort;
+
+  struct Meaning {
+    getField_t getField;  // in a model's csvHeader()
+    size_t     column;    // a Column
+  };
+  static Meaning const meanings[];
+
+  Arena                  arena;
+  size_t                 rows,
+                         nameSize,
+                         columns,                // present, in CSV order
+                         order[ COLUMNS ];
+  uint32_t             * pChannels;
+  void                 * pData[       COLUMNS ];
+  char const * const   * ppLabels[    COLUMNS ];
+  size_t                 labelCounts[ COLUMNS ];
+
+  void decode( Radio const * pRadio );
+  void decode( Radio const * pRadio, uint32_t wanted );   // just those columns (a bit per Column), untimed
+  bool encode( Radio       * pRadio ) const;
+
+  // One cell, shared with Radio's random access.  A text Column fills its width
+  // of "pText" (space-padded) and returns the size the model uses;  setCell()
+  // takes NUL-terminated text.
+  static uint32_t columnsOf( Radio const * pRadio, size_t * pOrder, size_t * pColumns );  // a bit per Column
+  static uint32_t getCell(   Radio const * pRadio, size_t index, Column column, char * pText );
+  static bool     setCell(   Radio       * pRadio, size_t index, Column column, uint32_t value, char const * pText );
+};
+
+#endif
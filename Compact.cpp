@@ -0,0 +1,144 @@
+//==================================================================================================
+//  Compact.cpp is the channel compaction class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#include "Compact.hpp"
+#include "Stats.hpp"
+
+enum {
+  BANKS       = 26,       // bank groups "A" to "Z";  any other is none
+  BANK_SLOTS  = 100       // bank channels "00" to "99"
+};
+
+size_t Compact::run( Radio               * pRadio,
+                     Radio::Ranges const * pFirst,
+                     bool                  isRenumbering ) {
+  Stats::Span  span( Stats::COMPACT );
+  size_t const channels = pRadio->getCount();
+  size_t const offset   = pRadio->getOffset();
+  size_t const bytes    = 2 * channels * sizeof( size_t );
+  size_t     * pTarget  = (size_t *)malloc( bytes );
+  if ( pTarget == 0 ) {
+    fprintf( stderr, "*** Out of memory (%lu bytes) ***\n", (unsigned long)bytes );
+    return (size_t)-1;
+  }
+  size_t     * pNext    = & pTarget[ channels ];    // the next index of each section
+  size_t       inUse    = 0;
+
+  for ( size_t index = channels;  index-- > 0;  ) {
+    pTarget[ index ] = (size_t)-1;
+    pNext[ pRadio->getSection( index ) ] = index;
+  }
+  for ( size_t range = 0;  pFirst != 0  &&  range < pFirst->count;  range++ ) {
+    for ( size_t channel = pFirst->first[ range ];  channel <= pFirst->last[ range ];  channel++ ) {
+      size_t index = channel - offset;
+      if ( index < channels  &&  pRadio->getValid( index ) ) {
+        pTarget[ index ] = pNext[ pRadio->getSection( index ) ]++;
+        inUse++;
+      }
+    }
+  }
+  for ( size_t pass = 0;  pass < 2;  pass++ ) {     // the rest in use, then those not
+    for ( size_t index = 0;  index < channels;  index++ ) {
+      if ( pTarget[ index ] == (size_t)-1  &&  pRadio->getValid( index ) == (pass == 0) ) {
+        pTarget[ index ] = pNext[ pRadio->getSection( index ) ]++;
+        inUse += pass == 0;
+      }
+    }
+  }
+  size_t moved = 0;
+  for ( size_t index = 0;  index < channels;  index++ ) {
+    moved += pTarget[ index ] != index  &&  pRadio->getValid( index );
+  }
+  if ( !apply( pRadio, pTarget ) ) {
+    moved = (size_t)-1;
+  } else if ( isRenumbering ) {
+    size_t renumbered = renumberBanks( pRadio );
+    if ( renumbered == (size_t)-1 ) {
+      free( pTarget );
+      return renumbered;
+    }
+    status( "--- Channels in use: %d;  moved: %d;  bank channels renumbered: %d ---\n",
+            (int)inUse, (int)moved, (int)renumbered );
+  } else {
+    status( "--- Channels in use: %d;  moved: %d ---\n", (int)inUse, (int)moved );
+  }
+  free( pTarget );
+  return moved;
+}
+
+bool Compact::apply( Radio  * pRadio,
+                     size_t * pTarget ) {
+  size_t const channels = pRadio->getCount();
+  for ( size_t index = 0;  index < channels;  index++ ) {
+    while ( pTarget[ index ] != index ) {            // along the cycle through "index"
+      size_t to = pTarget[ index ];
+      if ( !pRadio->swapChannels( index, to ) ) {
+        char work[ 256 ];
+        fprintf( stderr, "*** %s:  unable to move channel %d to %d ***\n", pRadio->getComment( work ),
+                 (int)(index + pRadio->getOffset()), (int)(to + pRadio->getOffset()) );
+        return false;
+      }
+      pTarget[ index ] = pTarget[ to ];              // "index" now has what was at "to"
+      pTarget[ to ]    = to;
+    }
+  }
+  return true;
+}
+
+static int compareKeys( void const * pLhs,
+                        void const * pRhs ) {
+  uint64_t lhs = *(uint64_t const *)pLhs;
+  uint64_t rhs = *(uint64_t const *)pRhs;
+  return lhs < rhs ? -1 : lhs > rhs;
+}
+
+size_t Compact::renumberBanks( Radio * pRadio ) {
+  uint32_t const present = ChannelFrame::columnsOf( pRadio, 0, 0 );
+  if ( (present & 1 << ChannelFrame::BANK_GROUP) == 0  ||  (present & 1 << ChannelFrame::BANK_CHANNEL) == 0 ) {
+    return 0;
+  }
+  size_t const channels = pRadio->getCount();
+  uint64_t   * pKeys    = (uint64_t *)malloc( channels * sizeof pKeys[ 0 ] );
+  size_t       keys     = 0;
+  if ( pKeys == 0 ) {
+    fprintf( stderr, "*** Out of memory (%lu bytes) ***\n", (unsigned long)(channels * sizeof pKeys[ 0 ]) );
+    return (size_t)-1;
+  }
+  for ( size_t index = 0;  index < channels;  index++ ) {   // group, bank channel & index, as one key
+    uint64_t group = pRadio->getValid( index ) ? ChannelFrame::getCell( pRadio, index, ChannelFrame::BANK_GROUP, 0 )
+                                               : (uint64_t)BANKS;
+    if ( group < BANKS ) {
+      uint64_t slot = ChannelFrame::getCell( pRadio, index, ChannelFrame::BANK_CHANNEL, 0 ) & 0xFFFF;
+      pKeys[ keys++ ] = group << 48 | slot << 32 | index;
+    }
+  }
+  qsort( pKeys, keys, sizeof pKeys[ 0 ], compareKeys );
+  size_t changed = 0;
+  size_t slot    = 0;
+  for ( size_t which = 0;  which < keys;  which++, slot++ ) {
+    if ( which == 0  ||  pKeys[ which ] >> 48 != pKeys[ which - 1 ] >> 48 ) {
+      slot = 0;
+    }
+    if ( slot < BANK_SLOTS  &&  slot != (pKeys[ which ] >> 32 & 0xFFFF) ) {
+      ChannelFrame::setCell( pRadio, (uint32_t)pKeys[ which ], ChannelFrame::BANK_CHANNEL, (uint32_t)slot, 0 );
+      changed++;
+    }
+  }
+  free( pKeys );
+  return changed;
+}
@@ -0,0 +1,57 @@
+//==================================================================================================
+//  Compact.hpp is the channel compaction class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  "--compact" moves the channels in use to the front of the image (of each
+//  section, for a model like the IC-91AD with a channel array per band), in
+//  their order, or first those of "--order" channel ranges, in the order given
+//  (e.g. "500,100-199" puts 500 first;  a channel listed twice is a parameter
+//  error), and the rest after them.  The target of every channel is decided
+//  first;  then one pass over the channel array follows each cycle of that
+//  permutation, exchanging whole channels with the model's swapChannels():  the
+//  records and every table kept per channel (skip & ignore bits, bank map,
+//  TH-D74 names & settings) move as bytes, so nothing goes through CSV text and
+//  no unknown byte is lost.  Bank channels are the user's, and stay as they
+//  are;  with "--banks", the channels of each bank are then renumbered 0, 1,
+//  2 ... in their bank order.
+
+#ifndef COMPACT_HPP
+#define COMPACT_HPP
+
+#include "ChannelFrame.hpp"
+
+class Compact {
+  Compact(             void                );  // Intentionally not implemented
+  Compact(             Compact const & rhs );  // Intentionally not implemented
+  Compact & operator=( Compact const & rhs );  // Intentionally not implemented
+
+ public:
+  // The channels in use that moved;  (size_t)-1 (with a message) if the model
+  // cannot swap channels, or if out of memory.  The channels of "pFirst" go first, if in use, in
+  // the order of its ranges (see Radio::Ranges::parse()'s "isOrdered").
+  static size_t   run(   Radio * pRadio, Radio::Ranges const * pFirst = 0, bool isRenumbering = false );
+
+  // Applies "pTarget" (the new index of each channel index, a permutation that
+  // keeps sections) in one pass;  "pTarget" ends up the identity.  False (with
+  // a message) if the model cannot swap channels.
+  static bool     apply( Radio * pRadio, size_t * pTarget );
+
+ private:
+  static size_t   renumberBanks( Radio * pRadio );   // bank channels changed, or (size_t)-1
+};
+
+#endif
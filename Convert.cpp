@@ -0,0 +1,212 @@
+//==================================================================================================
+//  Convert.cpp is the model conversion class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#include "Convert.hpp"
+#include "Stats.hpp"
+
+Convert::Rule const Convert::rules[ ChannelFrame::COLUMNS ]
+    = { { ChannelFrame::RX_HZ,            VALUE, "Rx frequency"     },
+        { ChannelFrame::TX_HZ,            VALUE, "Tx frequency"     },
+        { ChannelFrame::TX_OFFSET_HZ,     VALUE, "Tx offset"        },
+        { ChannelFrame::SPLIT,            LABEL, "split"            },
+        { ChannelFrame::RX_STEP_HZ,       VALUE, "Rx step"          },
+        { ChannelFrame::TX_STEP_HZ,       VALUE, "Tx step"          },
+        { ChannelFrame::MODULATION,       LABEL, "mode"             },
+        { ChannelFrame::FILTER,           VALUE, "filter"           },
+        { ChannelFrame::SKIP_MODE,        VALUE, "skip"             },
+        { ChannelFrame::FM_SQUELCH,       LABEL, "FM squelch"       },
+        { ChannelFrame::CTCSS_ENCODE_DHZ, VALUE, "CTCSS tone"       },
+        { ChannelFrame::CTCSS_DECODE_DHZ, VALUE, "CTCSS squelch"    },
+        { ChannelFrame::DCS_CODE,         VALUE, "DCS code"         },
+        { ChannelFrame::DCS_REVERSE,      LABEL, "DCS polarity"     },
+        { ChannelFrame::DV_SQUELCH,       LABEL, "DV squelch"       },
+        { ChannelFrame::DV_CSQL_CODE,     VALUE, "DV CSQL code"     },
+        { ChannelFrame::BANK_GROUP,       VALUE, "bank"             },
+        { ChannelFrame::BANK_CHANNEL,     VALUE, "bank channel"     },
+        { ChannelFrame::NAME,             TEXT,  "name"             },
+        { ChannelFrame::YOUR_CALL,        TEXT,  "your call sign"   },
+        { ChannelFrame::RPT1_CALL,        TEXT,  "RPT1 call sign"   },
+        { ChannelFrame::RPT2_CALL,        TEXT,  "RPT2 call sign"   } };
+
+// Only where the meaning is the same;  labels that match (ignoring case) need none.
+Convert::Alias const Convert::aliases[]
+    = { { ChannelFrame::SPLIT,      "OFF",             " "   },    // Icom / Kenwood
+        { ChannelFrame::SPLIT,      "DUP+",            "+"   },
+        { ChannelFrame::SPLIT,      "DUP-",            "-"   },
+        { ChannelFrame::MODULATION, "FM-N",            "NFM" },
+        { ChannelFrame::MODULATION, "DV",              "DR"  },
+        { ChannelFrame::FM_SQUELCH, "TONE",            "T"   },
+        { ChannelFrame::FM_SQUELCH, "TSQL",            "CT"  },
+        { ChannelFrame::FM_SQUELCH, "DTCS",            "DCS" },
+        { ChannelFrame::FM_SQUELCH, "DTCS(T)",         "D_O" },
+        { ChannelFrame::FM_SQUELCH, "TONE(T)/DTCS(R)", "T_D" },
+        { ChannelFrame::FM_SQUELCH, "DTCS(T)/TSQL(R)", "D_C" },
+        { ChannelFrame::FM_SQUELCH, "TONE(T)/TSQL(R)", "T_C" } };
+
+char const * Convert::canonical( ChannelFrame::Column column,
+                                 char const         * pLabel ) {
+  for ( size_t index = 0;  index < COUNT_OF( aliases );  index++ ) {
+    if ( aliases[ index ].column == (size_t)column  &&  stricmp( pLabel, aliases[ index ].pAlias ) == 0 ) {
+      return aliases[ index ].pLabel;
+    }
+  }
+  return pLabel;
+}
+
+int Convert::label( Radio const        * pSource,
+                    Radio const        * pTarget,
+                    ChannelFrame::Column column,
+                    uint32_t             code ) {
+  size_t               sourceCount,
+                       targetCount;
+  char const * const * pSourceLabels = ChannelFrame::labelsOf( pSource, column, & sourceCount );
+  char const * const * pTargetLabels = ChannelFrame::labelsOf( pTarget, column, & targetCount );
+  if ( pSourceLabels == 0  ||  pTargetLabels == 0  ||  code >= sourceCount  ||  *pSourceLabels[ code ] == '?' ) {
+    return -1;            // "?n?" is a code the model does not name
+  }
+  char const * pLabel = pSourceLabels[ code ];
+  int          result = search( pLabel, pTargetLabels, targetCount );
+  for ( size_t index = 0;  result < 0  &&  index < COUNT_OF( aliases );  index++ ) {
+    if ( aliases[ index ].column != (size_t)column ) {
+      continue;
+    }
+    if ( stricmp( pLabel, aliases[ index ].pLabel ) == 0 ) {
+      result = search( aliases[ index ].pAlias, pTargetLabels, targetCount );
+    } else if ( stricmp( pLabel, aliases[ index ].pAlias ) == 0 ) {
+      result = search( aliases[ index ].pLabel, pTargetLabels, targetCount );
+    }
+  }
+  return result;
+}
+
+bool Convert::isImplied( Radio const        * pTarget,
+                        size_t               index,
+                        uint32_t             present,
+                        ChannelFrame::Column column,
+                        uint32_t             value ) {
+  uint32_t const needs = 1 << ChannelFrame::RX_HZ | 1 << ChannelFrame::SPLIT | 1 << ChannelFrame::TX_OFFSET_HZ;
+  if ( column == ChannelFrame::TX_STEP_HZ ) {
+    return (present & 1 << ChannelFrame::RX_STEP_HZ) != 0
+        &&  ChannelFrame::getCell( pTarget, index, ChannelFrame::RX_STEP_HZ, 0 ) == value;
+  }
+  if ( column != ChannelFrame::TX_HZ  ||  (present & 1 << ChannelFrame::RX_HZ) == 0 ) {
+    return false;
+  }
+  uint32_t const rxHz = ChannelFrame::getCell( pTarget, index, ChannelFrame::RX_HZ, 0 );
+  if ( value == rxHz ) {
+    return true;
+  } else if ( (present & needs) != needs ) {
+    return false;
+  }
+  size_t               count;
+  char const * const * pSplits = ChannelFrame::labelsOf( pTarget, ChannelFrame::SPLIT, & count );
+  uint32_t     const   split   = ChannelFrame::getCell( pTarget, index, ChannelFrame::SPLIT,        0 ),
+                       offset  = ChannelFrame::getCell( pTarget, index, ChannelFrame::TX_OFFSET_HZ, 0 );
+  char const         * pSplit  = pSplits != 0  &&  split < count ? canonical( ChannelFrame::SPLIT, pSplits[ split ] ) : "";
+  return (stricmp( pSplit, "DUP+" ) == 0  &&  value == rxHz + offset)
+      || (stricmp( pSplit, "DUP-" ) == 0  &&  value == rxHz - offset);
+}
+
+size_t Convert::run( Radio const * pSource,
+                     Radio       * pTarget ) {
+  Stats::Span  span( Stats::LOAD );
+  size_t const offset = pTarget->getOffset();
+  size_t       order[ ChannelFrame::COLUMNS ],
+               columns,
+               lost[  ChannelFrame::COLUMNS + 1 ],       // + 1:  channel numbers the target lacks
+               first[ ChannelFrame::COLUMNS + 1 ],
+               count    = 0,
+               nameSize = 0;
+  uint32_t     present  = ChannelFrame::columnsOf( pTarget, order, & columns );
+
+  memset( lost, 0, sizeof lost );
+  if ( (present & 1 << ChannelFrame::NAME) != 0 ) {
+    pTarget->getName( 0, & nameSize );
+    nameSize = nameSize < ChannelFrame::NAME_SIZE ? nameSize : (size_t)ChannelFrame::NAME_SIZE;
+  }
+  for ( size_t channel = pSource->nextChannel( 0 );  channel != (size_t)-1;
+               channel = pSource->nextChannel( channel + 1 ) ) {
+    Channel from;
+    size_t  index = channel - offset;
+    pSource->getChannel( channel, from );
+    if ( index >= pTarget->getCount() ) {
+      first[ ChannelFrame::COLUMNS ] = lost[ ChannelFrame::COLUMNS ]++ ? first[ ChannelFrame::COLUMNS ] : channel;
+      continue;
+    }
+    pTarget->setValid( index, true );          // the model's defaults, as in a CSV load
+    if ( (present & 1 << ChannelFrame::BANK_GROUP) != 0 ) {      // in no bank, unless the source says
+      ChannelFrame::setCell( pTarget, index, ChannelFrame::BANK_GROUP,   (uint32_t)-1, 0 );
+      ChannelFrame::setCell( pTarget, index, ChannelFrame::BANK_CHANNEL, (uint32_t)-1, 0 );
+    }
+    count++;
+    for ( size_t which = 0;  which < columns;  which++ ) {     // in the target's CSV order, as a load
+      ChannelFrame::Column column = (ChannelFrame::Column)order[ which ];
+      bool                 isKept = true;
+      if ( (from.present & 1 << column) == 0 ) {
+        continue;                              // the target's default
+      } else if ( column < ChannelFrame::NAME ) {
+        uint32_t value = from.values[ column ];
+        if ( value == ChannelFrame::UNKNOWN ) {
+          continue;
+        }
+        int      code  = rules[ column ].how == LABEL ? label( pSource, pTarget, column, value ) : (int)value;
+        isKept = code >= 0  &&  ChannelFrame::setCell( pTarget, index, column, code, 0 );
+      } else {
+        char const * pText  = column == ChannelFrame::NAME ? from.name : from.calls[ column - ChannelFrame::YOUR_CALL ];
+        size_t       size   = column == ChannelFrame::NAME ? nameSize  : (size_t)ChannelFrame::CALL_SIZE;
+        size_t       length = strlen( pText );
+        char         work[ ChannelFrame::NAME_SIZE + 1 ];
+        while ( length > 0  &&  pText[ length - 1 ] == ' ' ) {
+          length--;
+        }
+        isKept = length <= size;
+        length = isKept ? length : size;
+        memcpy( work, pText, length );
+        work[ length ] = 0;
+        isKept = ChannelFrame::setCell( pTarget, index, column, 0, work )  &&  isKept;
+      }
+      if ( !isKept ) {
+        first[ column ] = lost[ column ]++ ? first[ column ] : channel;
+      }
+    }
+    for ( size_t column = 0;  column < ChannelFrame::COLUMNS;  column++ ) {
+      if ( (from.present & ~present & 1 << column) != 0
+          &&  (column < ChannelFrame::NAME ? from.values[ column ] + 1 > 1           // neither 0 nor UNKNOWN
+                                              &&  !isImplied( pTarget, index, present, (ChannelFrame::Column)column,
+                                                              from.values[ column ] )
+                                            : *(column == ChannelFrame::NAME ? from.name
+                                                : from.calls[ column - ChannelFrame::YOUR_CALL ]) > ' ') ) {
+        first[ column ] = lost[ column ]++ ? first[ column ] : channel;     // the target lacks the column
+      }
+    }
+  }
+
+  size_t total = 0;
+  status( "--- Channels converted: %d ---\n", (int)count );
+  for ( size_t column = 0;  column <= ChannelFrame::COLUMNS;  column++ ) {
+    if ( lost[ column ] > 0 ) {
+      status( "--- Not converted:  %s of %d channels (first:  %d) ---\n",
+              column < ChannelFrame::COLUMNS ? rules[ column ].pName : "the channel number",
+              (int)lost[ column ], (int)first[ column ] );
+      total += lost[ column ];
+    }
+  }
+  Stats::add( Stats::CHANNELS,     count );
+  Stats::add( Stats::PARSE_ERRORS, total );
+  return total;
+}
@@ -0,0 +1,75 @@
+//==================================================================================================
+//  Convert.hpp is the model conversion class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  "--convert" copies the channels of one model's image into an image of
+//  another model (or the same one), through typed values instead of CSV text:
+//  each channel is read with Radio::getChannel() and written, a column at a
+//  time in the target's CSV order, through the model's typed setters.  The
+//  rules below declare how each column crosses models:  VALUE columns keep
+//  their number (Hz, tenths of a Hz, a DCS or bank code, ...);  LABEL columns
+//  keep the model's name for the code (e.g. "FM-N"), or a declared alias for
+//  it (e.g. Kenwood's "NFM");  TEXT columns are cut to the target's width.
+//
+//  A channel keeps its number, and starts from the target model's defaults,
+//  as in a CSV import, in no bank;  the target's other channels are left as
+//  they are.  A value that does not survive (a non-zero value or text in a
+//  column the target lacks, a value out of its range, a label it has no alias
+//  for, text cut short, or a channel number it does not have) is counted, &
+//  reported per column, with the first such channel.  A Tx frequency or step
+//  the target has no column for still survives if its other columns give the
+//  same:  the Rx frequency (or it with the duplex offset), or the Rx step.
+
+#ifndef CONVERT_HPP
+#define CONVERT_HPP
+
+#include "ChannelFrame.hpp"
+
+class Convert {
+  Convert(             void                );  // Intentionally not implemented
+  Convert(             Convert const & rhs );  // Intentionally not implemented
+  Convert & operator=( Convert const & rhs );  // Intentionally not implemented
+
+ public:
+  static size_t       run(       Radio const * pSource, Radio * pTarget );   // the values lost
+  static char const * canonical( ChannelFrame::Column column, char const * pLabel );  // the first of its aliases
+
+ private:
+  enum How {
+    VALUE,
+    LABEL,
+    TEXT
+  };
+  struct Rule {
+    ChannelFrame::Column column;
+    How                  how;
+    char const         * pName;         // for the report
+  };
+  struct Alias {                        // the same meaning, in two models' labels
+    size_t               column;        // a ChannelFrame::Column
+    char const         * pLabel,
+                       * pAlias;
+  };
+  static Rule  const rules[   ChannelFrame::COLUMNS ];   // in Column order
+  static Alias const aliases[];
+
+  static int  label(     Radio const * pSource, Radio const * pTarget, ChannelFrame::Column column, uint32_t code );
+  static bool isImplied( Radio const * pTarget, size_t index, uint32_t present, ChannelFrame::Column column,
+                         uint32_t value );    // by the columns the target has
+};
+
+#endif
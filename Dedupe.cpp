@@ -0,0 +1,223 @@
+//==================================================================================================
+//  Dedupe.cpp is the duplicate channel detection class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#include "Dedupe.hpp"
+#include "Convert.hpp"
+#include "Stats.hpp"
+
+Dedupe::Dedupe( void )
+    : pEntries( 0 ), entryCount( 0 ), entryLimit( 0 ), images( 0 ), pSlots( 0 ), slotCount( 0 ) {}
+
+Dedupe::~Dedupe( void ) {
+  free( pEntries );
+  free( pSlots   );
+}
+
+static char const * labelOf( Radio const        * pRadio,       // by meaning;  "" if absent or unknown
+                             uint32_t             present,
+                             ChannelFrame::Column column,
+                             uint32_t             code ) {
+  size_t               count  = 0;
+  char const * const * labels = (present & 1 << column) != 0 ? ChannelFrame::labelsOf( pRadio, column, & count ) : 0;
+  return labels != 0  &&  code < count ? Convert::canonical( column, labels[ code ] ) : "";
+}
+
+static size_t putText( uint8_t * pKey, char const * pText, size_t size ) {   // uppercase, without trailing spaces
+  while ( size > 0  &&  (pText[ size - 1 ] == ' '  ||  pText[ size - 1 ] == 0) ) {
+    size--;
+  }
+  pKey[ 0 ] = (uint8_t)size;
+  for ( size_t index = 0;  index < size;  index++ ) {
+    pKey[ index + 1 ] = (uint8_t)toupper( pText[ index ] );
+  }
+  return size + 1;
+}
+
+static size_t putValue( uint8_t * pKey, uint32_t value ) {
+  memcpy( pKey, & value, sizeof value );
+  return sizeof value;
+}
+
+size_t Dedupe::keyOf( Radio const * pRadio,
+                      size_t        index,
+                      uint32_t      present,
+                      uint8_t     * pKey ) {
+  uint32_t values[ ChannelFrame::NAME ];
+  for ( size_t column = 0;  column < ChannelFrame::NAME;  column++ ) {
+    values[ column ] = (present & 1 << column) != 0 ? ChannelFrame::getCell( pRadio, index, (ChannelFrame::Column)column, 0 )
+                                                    : (uint32_t)ChannelFrame::UNKNOWN;
+  }
+  char const * pSplit   = labelOf( pRadio, present, ChannelFrame::SPLIT,      values[ ChannelFrame::SPLIT      ] );
+  char const * pSquelch = labelOf( pRadio, present, ChannelFrame::FM_SQUELCH, values[ ChannelFrame::FM_SQUELCH ] );
+  char const * pMode    = labelOf( pRadio, present, ChannelFrame::MODULATION, values[ ChannelFrame::MODULATION ] );
+  bool         isSplit  = *pSplit   != 0  &&  stricmp( pSplit,   "OFF" ) != 0;
+  bool         isTone   = *pSquelch != 0  &&  stricmp( pSquelch, "OFF" ) != 0;
+  size_t       size     = putValue( pKey, values[ ChannelFrame::RX_HZ ] );
+  size += putText(  & pKey[ size ], pSplit, strlen( pSplit ) );
+  size += putValue( & pKey[ size ], isSplit ? values[ ChannelFrame::TX_OFFSET_HZ ] : 0 );
+  size += putText(  & pKey[ size ], pMode, strlen( pMode ) );
+  size += putText(  & pKey[ size ], pSquelch, strlen( pSquelch ) );
+  if ( isTone ) {
+    char const * pPolarity = labelOf( pRadio, present, ChannelFrame::DCS_REVERSE, values[ ChannelFrame::DCS_REVERSE ] );
+    size += putValue( & pKey[ size ], values[ ChannelFrame::CTCSS_ENCODE_DHZ ] );
+    size += putValue( & pKey[ size ], values[ ChannelFrame::CTCSS_DECODE_DHZ ] );
+    size += putValue( & pKey[ size ], values[ ChannelFrame::DCS_CODE         ] );
+    size += putText(  & pKey[ size ], pPolarity, strlen( pPolarity ) );
+  }
+  for ( size_t column = ChannelFrame::YOUR_CALL;  column <= ChannelFrame::RPT2_CALL;  column++ ) {
+    char work[ ChannelFrame::NAME_SIZE ];
+    size_t length = (present & 1 << column) != 0 ? ChannelFrame::getCell( pRadio, index, (ChannelFrame::Column)column, work ) : 0;
+    size += putText( & pKey[ size ], work, length );
+  }
+  return size;
+}
+
+size_t Dedupe::find( uint64_t        hash,
+                     uint8_t const * pKey,
+                     size_t          keySize ) const {
+  size_t slot = (size_t)hash & (slotCount - 1);
+  while ( pSlots[ slot ] != 0 ) {
+    Entry const & entry = pEntries[ pSlots[ slot ] - 1 ];
+    if ( entry.hash == hash  &&  entry.keySize == keySize  &&  memcmp( entry.pKey, pKey, keySize ) == 0 ) {
+      break;
+    }
+    slot = (slot + 1) & (slotCount - 1);
+  }
+  return slot;
+}
+
+void Dedupe::grow( void ) {               // keep the table at most half full
+  free( pSlots );
+  slotCount = slotCount ? slotCount * 2 : 1024;
+  pSlots    = (uint32_t *)calloc( slotCount, sizeof pSlots[ 0 ] );
+  for ( size_t ordinal = 0;  ordinal < entryCount;  ordinal++ ) {
+    Entry const & entry = pEntries[ ordinal ];
+    if ( entry.first == ordinal ) {
+      pSlots[ find( entry.hash, (uint8_t const *)entry.pKey, entry.keySize ) ] = (uint32_t)(ordinal + 1);
+    }
+  }
+}
+
+void Dedupe::add( Radio const * pRadio ) {
+  Stats::Span    span( Stats::DUMP );
+  uint32_t const present = ChannelFrame::columnsOf( pRadio, 0, 0 );
+  size_t   const offset  = pRadio->getOffset();
+  size_t         count   = 0;
+  for ( size_t index = 0;  index < pRadio->getCount();  index++ ) {
+    if ( !pRadio->getValid( index ) ) {
+      continue;
+    }
+    if ( entryCount == entryLimit ) {
+      entryLimit = entryLimit ? entryLimit * 2 : 1024;
+      pEntries   = (Entry *)realloc( pEntries, entryLimit * sizeof (Entry) );
+    }
+    if ( (entryCount + 1) * 2 > slotCount ) {
+      grow();
+    }
+    uint8_t  key[ MAX_KEY ];
+    size_t   keySize = keyOf( pRadio, index, present, key );
+    uint64_t hash    = 14695981039346656037ULL;   // FNV-1a
+    for ( size_t which = 0;  which < keySize;  which++ ) {
+      hash = (hash ^ key[ which ]) * 1099511628211ULL;
+    }
+    char     name[ ChannelFrame::NAME_SIZE ];
+    size_t   nameSize = (present & 1 << ChannelFrame::NAME) != 0
+                      ? ChannelFrame::getCell( pRadio, index, ChannelFrame::NAME, name ) : 0;
+    while ( nameSize > 0  &&  name[ nameSize - 1 ] == ' ' ) {
+      nameSize--;
+    }
+    size_t   ordinal  = entryCount++;
+    size_t   slot     = find( hash, key, keySize );
+    Entry  & entry    = pEntries[ ordinal ];
+    entry.hash     = hash;
+    entry.pKey     = (char const *)memcpy( arena.allocate( keySize ), key, keySize );
+    entry.pName    = (char const *)memcpy( arena.allocate( nameSize + 1 ), name, nameSize );
+    entry.keySize  = (uint16_t)keySize;
+    entry.nameSize = (uint16_t)nameSize;
+    entry.image    = (uint32_t)images;
+    entry.channel  = (uint32_t)(index + offset);
+    entry.next     = NONE;
+    entry.last     = (uint32_t)ordinal;
+    entry.members  = 1;
+    entry.isSpare  = false;
+    if ( pSlots[ slot ] == 0 ) {
+      pSlots[ slot ] = (uint32_t)(ordinal + 1);
+      entry.first    = (uint32_t)ordinal;
+    } else {
+      Entry & first  = pEntries[ pSlots[ slot ] - 1 ];
+      entry.first    = pSlots[ slot ] - 1;
+      entry.isSpare  = pEntries[ first.last ].image == images;   // the group has one in this image already
+      pEntries[ first.last ].next = (uint32_t)ordinal;
+      first.last     = (uint32_t)ordinal;
+      first.members++;
+    }
+    count++;
+  }
+  images++;
+  Stats::add( Stats::CHANNELS, count );
+}
+
+size_t Dedupe::report( Output             & output,
+                       char const * const * ppNames ) const {
+  size_t groups     = 0,
+         duplicates = 0,
+         near       = 0;
+  output.printf( "Group,Radio File,Channel,Name\n" );
+  for ( size_t ordinal = 0;  ordinal < entryCount;  ordinal++ ) {
+    Entry const & first = pEntries[ ordinal ];
+    if ( first.first != ordinal  ||  first.members < 2 ) {
+      continue;
+    }
+    bool isNear = false;
+    groups++;
+    duplicates += first.members - 1;
+    for ( size_t member = ordinal;  member != NONE;  member = pEntries[ member ].next ) {
+      Entry const & entry = pEntries[ member ];
+      char          work[ ChannelFrame::NAME_SIZE * 2 + 3 ];
+      escape( work, entry.pName, entry.nameSize );
+      output.printf( "%d,%s,%d,%s\n", (int)groups, ppNames[ entry.image ], (int)entry.channel, work );
+      isNear |= entry.nameSize != first.nameSize  ||  memcmp( entry.pName, first.pName, first.nameSize ) != 0;
+    }
+    near += isNear;
+  }
+  status( "--- Channels: %d;  duplicate groups: %d (%d with differing names);  duplicates: %d ---\n",
+          (int)entryCount, (int)groups, (int)near, (int)duplicates );
+  return duplicates;
+}
+
+size_t Dedupe::consolidate( Radio * pRadio,
+                            size_t  image ) const {
+  size_t low  = 0,                        // the image's first entry:  entries go in image order
+         high = entryCount,
+         count = 0;
+  while ( low < high ) {
+    size_t middle = (low + high) / 2;
+    if ( pEntries[ middle ].image < image ) {
+      low  = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  for (  ;  low < entryCount  &&  pEntries[ low ].image == image;  low++ ) {
+    if ( pEntries[ low ].isSpare ) {
+      pRadio->setValid( pEntries[ low ].channel - pRadio->getOffset(), false );
+      count++;
+    }
+  }
+  return count;
+}
@@ -0,0 +1,82 @@
+//==================================================================================================
+//  Dedupe.hpp is the duplicate channel detection class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  "--dupes" finds the channels, across any number of radio files of any
+//  models, that are the same channel whatever their names:  the same receive
+//  frequency, split & offset, mode, squelch with its tones or DCS code &
+//  polarity, and D-STAR routing (your, RPT1 & RPT2 call signs).  Labels are
+//  compared by meaning (see Convert's aliases), an offset only when there is a
+//  split, and tones & DCS only when the squelch is not OFF.  Each channel's key
+//  goes through one hash index of the groups, so the work is linear in the
+//  channels, not pairwise.  A group whose names differ is a near-duplicate.
+//
+//  consolidate() takes all but the first channel of each group out of use in
+//  one image;  channels of a group in other images are left alone.
+
+#ifndef DEDUPE_HPP
+#define DEDUPE_HPP
+
+#include "ChannelFrame.hpp"
+
+class Dedupe {
+  Dedupe(             Dedupe const & rhs );  // Intentionally not implemented
+  Dedupe & operator=( Dedupe const & rhs );  // Intentionally not implemented
+
+ public:
+  enum {
+    NONE     = 0xFFFFFFFF,
+    MAX_KEY  = 256        // bytes
+  };
+
+  Dedupe( void );
+  ~Dedupe( void );
+
+  void   add(         Radio const * pRadio );            // the next image's channels in use
+  size_t report(      Output & output, char const * const * ppNames ) const;   // the duplicates
+  size_t consolidate( Radio  * pRadio, size_t image ) const;   // the channels taken out of use
+
+ private:
+  struct Entry {          // a channel in use
+    uint64_t     hash;
+    char const * pKey;    // in the arena
+    char const * pName;
+    uint16_t     keySize,
+                 nameSize;
+    uint32_t     image,
+                 channel, // as in the CSV
+                 first,   // the group's first entry
+                 next,    // the group's next entry, or NONE
+                 last,    // on a group's first entry:  its last entry
+                 members, // on a group's first entry
+                 isSpare; // not the group's first in its image
+  };
+
+  Entry    * pEntries;
+  size_t     entryCount,
+             entryLimit,
+             images;
+  uint32_t * pSlots;      // open-addressed hash table of (a group's first entry + 1)
+  size_t     slotCount;
+  Arena      arena;
+
+  static size_t keyOf( Radio const * pRadio, size_t index, uint32_t present, uint8_t * pKey );
+  size_t        find(  uint64_t hash, uint8_t const * pKey, size_t keySize ) const;   // its slot, used or not
+  void          grow(  void );
+};
+
+#endif
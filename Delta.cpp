@@ -0,0 +1,138 @@
+//==================================================================================================
+//  Delta.cpp is the binary image delta class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#include "Delta.hpp"
+
+static char const deltaMagic[] = "R2CD";
+
+enum {
+  deltaVersion = 1
+};
+
+bool Delta::make( Radio const * pBase,
+                  Radio const * pTarget,
+                  FILE        * pFile ) {
+  size_t modelLength = strcspn( pBase->pHeader, "\r\n" );   // an ICF header starts with the model code
+  if ( pBase->csvHeader() != pTarget->csvHeader()  ||  pBase->size != pTarget->size
+      ||  modelLength != strcspn( pTarget->pHeader, "\r\n" )
+      ||  strncmp( pBase->pHeader, pTarget->pHeader, modelLength ) != 0 ) {
+    fprintf( stderr, "*** Images are not of the same radio model ***\n" );
+    return false;
+  }
+
+  // Two passes over the images:  the first counts the runs for the file header.
+  uint8_t prefix[ 8 ] = { 0 };
+  uint8_t digest[ Sha256::DIGEST_SIZE ];
+  bool    isOk;
+  size_t  runCount = 0,
+          runBytes = 0;
+  memcpy( prefix, deltaMagic, 4 );
+  prefix[ 4 ] = deltaVersion;
+  isOk = fwrite( prefix, sizeof prefix, 1, pFile ) == 1;
+  pBase->digest( digest );
+  isOk = isOk  &&  fwrite( digest, sizeof digest, 1, pFile ) == 1;
+  Sha256 sha256;
+  sha256.update( pBase->pHeader,   strlen( pBase->pHeader ) );
+  sha256.update( pTarget->pData,   pTarget->size );
+  sha256.final(  digest );
+  isOk = isOk  &&  fwrite( digest, sizeof digest, 1, pFile ) == 1;
+  isOk = isOk  &&  putLE32( pFile, (uint32_t)pBase->size );
+  for ( int pass = 0;  isOk  &&  pass < 2;  pass++ ) {
+    if ( pass > 0 ) {
+      isOk = putLE32( pFile, (uint32_t)runCount );
+    }
+    for ( size_t offset = 0;  isOk  &&  offset < pBase->size;  ) {
+      if ( pBase->pData[ offset ] == pTarget->pData[ offset ] ) {
+        offset++;
+        continue;
+      }
+      // A run ends at an unchanged gap long enough to pay for another run header.
+      size_t end  = offset + 1,
+             same = 0;
+      for ( size_t index = end;  index < pBase->size  &&  same < RUN_HEADER;  index++ ) {
+        if ( pBase->pData[ index ] == pTarget->pData[ index ] ) {
+          same++;
+        } else {
+          same = 0;
+          end  = index + 1;
+        }
+      }
+      if ( pass == 0 ) {
+        runCount++;
+        runBytes += end - offset;
+      } else {
+        isOk = putLE32( pFile, (uint32_t)offset )
+            && putLE32( pFile, (uint32_t)(end - offset) )
+            && fwrite( & pTarget->pData[ offset ], 1, end - offset, pFile ) == end - offset;
+      }
+      offset = end;
+    }
+  }
+  if ( !isOk ) {
+    fprintf( stderr, "*** Unable to write delta file ***\n" );
+    return false;
+  }
+  status( "--- Runs: %d, bytes changed: %d ---\n", (int)runCount, (int)runBytes );
+  return true;
+}
+
+bool Delta::apply( Radio * pBase,
+                   FILE  * pFile ) {
+  uint8_t  prefix[ 8 ],
+           baseDigest[   Sha256::DIGEST_SIZE ],
+           targetDigest[ Sha256::DIGEST_SIZE ],
+           digest[       Sha256::DIGEST_SIZE ];
+  uint32_t size,
+           runCount;
+
+  if ( fread( prefix, sizeof prefix, 1, pFile ) != 1
+      ||  memcmp( prefix, deltaMagic, 4 ) != 0  ||  prefix[ 4 ] != deltaVersion
+      ||  fread( baseDigest,   sizeof baseDigest,   1, pFile ) != 1
+      ||  fread( targetDigest, sizeof targetDigest, 1, pFile ) != 1
+      ||  !getLE32( pFile, & size )
+      ||  !getLE32( pFile, & runCount ) ) {
+    fprintf( stderr, "*** Invalid delta file format ***\n" );
+    return false;
+  }
+  pBase->digest( digest );
+  if ( size != pBase->size  ||  memcmp( digest, baseDigest, sizeof digest ) != 0 ) {
+    fprintf( stderr, "*** Delta file does not apply to this image ***\n" );
+    return false;
+  }
+
+  // One pass, straight into the image;  a failure past this point leaves the image unusable.
+  size_t previous = 0;
+  for ( uint32_t run = 0;  run < runCount;  run++ ) {
+    uint32_t offset,
+             length;
+    if ( !getLE32( pFile, & offset )  ||  !getLE32( pFile, & length )
+        ||  offset < previous  ||  length > size - offset
+        ||  fread( & pBase->pData[ offset ], 1, length, pFile ) != length ) {
+      fprintf( stderr, "*** Invalid delta file data (run %d) ***\n", (int)run );
+      return false;
+    }
+    previous = offset + length;
+  }
+  pBase->digest( digest );
+  if ( memcmp( digest, targetDigest, sizeof digest ) != 0 ) {
+    fprintf( stderr, "*** Delta result does not match its expected image ***\n" );
+    return false;
+  }
+  status( "--- Runs applied: %d ---\n", (int)runCount );
+  return true;
+}
@@ -0,0 +1,48 @@
+//==================================================================================================
+//  Delta.hpp is the binary image delta class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  A delta file updates one exact image (its "base") to another image of the
+//  same radio model.  All numbers are little-endian:
+//    8 bytes   "R2CD", version, 3 zero bytes
+//    32 bytes  SHA-256 of the base image (the same id used by the image store)
+//    32 bytes  SHA-256 of the resulting image
+//    4 bytes   image size
+//    4 bytes   run count;  then for each run, in increasing offset order:
+//      4 bytes offset, 4 bytes length, and "length" replacement bytes.
+//  The file header is never changed by a delta;  only the image data.
+
+#ifndef DELTA_HPP
+#define DELTA_HPP
+
+#include "Hash.hpp"
+
+class Delta {
+  Delta(             void              );  // Intentionally not implemented
+  Delta(             Delta const & rhs );  // Intentionally not implemented
+  Delta & operator=( Delta const & rhs );  // Intentionally not implemented
+
+ public:
+  enum {
+    RUN_HEADER = 8        // offset & length;  a shorter unchanged gap is cheaper to resend
+  };
+
+  static bool make(  Radio const * pBase, Radio const * pTarget, FILE * pFile );
+  static bool apply( Radio       * pBase, FILE        * pFile );
+};
+
+#endif
@@ -16,6 +16,9 @@
 //  with this program; if not, write to the Free Software Foundation, Inc.,
 //  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
+#ifndef DSTAR_HPP
+#define DSTAR_HPP
+
 #include "Radio.hpp"
 
 struct MyCall {
@@ -107,6 +110,8 @@ class Dstar : public Radio {
   Dstar & operator=( Dstar const & rhs );  // Intentionally not implemented
 
  protected:
+  friend class ChannelFrame;
+  friend class Generate;
   static char const * const dvSquelches[  3 ];
   static char const * const fmSquelches[ 12 ];
   static double       const tuneSteps[   14 ];
@@ -122,6 +127,15 @@ class Dstar : public Radio {
   virtual bool                 setSkip(          size_t   index, bool               value   )       = 0;
   virtual bool                 getSkipp(         size_t   index                             ) const = 0;
   virtual bool                 setSkipp(         size_t   index, bool               value   )       = 0;
+  void                         swapFlags(        size_t   a,     size_t             b       ) {
+    bool ignore = getIgnore( a ),  skip = getSkip( a ),  skipp = getSkipp( a );
+    setIgnore( a, getIgnore( b ) );
+    setSkip(   a, getSkip(   b ) );
+    setSkipp(  a, getSkipp(  b ) );
+    setIgnore( b, ignore );
+    setSkip(   b, skip   );
+    setSkipp(  b, skipp  );
+  }
 
   virtual bits_t               getSkipMode(      size_t   index                             ) const {
     return getSkipp( index ) ? 2 : getSkip(  index ) ? 1 : 0;
@@ -268,3 +282,5 @@ class Dstar : public Radio {
  public:
   virtual ~Dstar( void ) {}
 };
+
+#endif
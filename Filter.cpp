@@ -0,0 +1,360 @@
+//==================================================================================================
+//  Filter.cpp is the channel filter class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#include "Filter.hpp"
+
+Filter::Field const Filter::fields[]
+    = { { "channel",  CHANNEL,                        CODE      },
+        { "rx",       ChannelFrame::RX_HZ,            FREQUENCY },
+        { "tx",       ChannelFrame::TX_HZ,            FREQUENCY },
+        { "offset",   ChannelFrame::TX_OFFSET_HZ,     FREQUENCY },
+        { "split",    ChannelFrame::SPLIT,            LABEL     },
+        { "step",     ChannelFrame::RX_STEP_HZ,       STEP      },
+        { "txstep",   ChannelFrame::TX_STEP_HZ,       STEP      },
+        { "mode",     ChannelFrame::MODULATION,       LABEL     },
+        { "filter",   ChannelFrame::FILTER,           CODE      },
+        { "skip",     ChannelFrame::SKIP_MODE,        CODE      },
+        { "squelch",  ChannelFrame::FM_SQUELCH,       LABEL     },
+        { "tone",     ChannelFrame::CTCSS_ENCODE_DHZ, TONE      },
+        { "tsql",     ChannelFrame::CTCSS_DECODE_DHZ, TONE      },
+        { "dcs",      ChannelFrame::DCS_CODE,         CODE      },
+        { "polarity", ChannelFrame::DCS_REVERSE,      LABEL     },
+        { "dvsql",    ChannelFrame::DV_SQUELCH,       LABEL     },
+        { "csql",     ChannelFrame::DV_CSQL_CODE,     CODE      },
+        { "bank",     ChannelFrame::BANK_GROUP,       LETTER    },
+        { "group",    ChannelFrame::BANK_GROUP,       LETTER    },
+        { "slot",     ChannelFrame::BANK_CHANNEL,     CODE      },
+        { "name",     ChannelFrame::NAME,             TEXT      },
+        { "your",     ChannelFrame::YOUR_CALL,        TEXT      },
+        { "rpt1",     ChannelFrame::RPT1_CALL,        TEXT      },
+        { "rpt2",     ChannelFrame::RPT2_CALL,        TEXT      } };
+
+static bool fail( char const * pText, char const * pMessage ) {
+  fprintf( stderr, "*** Invalid filter expression;  %s at '%.20s' ***\n", pMessage, *pText ? pText : "(end)" );
+  return false;
+}
+
+static char const * skip( char const * pText ) {
+  while ( isspace( *pText ) ) {
+    pText++;
+  }
+  return pText;
+}
+
+static bool isWord( char const ** ppText, char const * pWord ) {   // consumed if so
+  char const * pText  = skip( *ppText );
+  size_t       length = strlen( pWord );
+  for ( size_t index = 0;  index < length;  index++ ) {
+    if ( tolower( pText[ index ] ) != pWord[ index ] ) {
+      return false;
+    }
+  }
+  if ( isalnum( pText[ length ] ) ) {
+    return false;
+  }
+  *ppText = pText + length;
+  return true;
+}
+
+static size_t token( char const * pText ) {   // a bare word or number's length
+  size_t length = 0;
+  while ( pText[ length ] != 0  &&  !isspace( pText[ length ] )  &&  strchr( "()=!<>\"'", pText[ length ] ) == 0 ) {
+    length++;
+  }
+  return length;
+}
+
+bool Filter::compile( char const * pExpression ) {
+  nodes = 0;
+  char const * pText = pExpression;
+  if ( !parseOr( & pText ) ) {
+    return false;
+  }
+  pText = skip( pText );
+  return *pText == 0 ? true : fail( pText, "unexpected text" );
+}
+
+bool Filter::push( Node const & node ) {
+  if ( nodes >= MAX_NODES ) {
+    fprintf( stderr, "*** Invalid filter expression;  more than %d terms ***\n", (int)MAX_NODES / 2 );
+    return false;
+  }
+  program[ nodes++ ] = node;
+  return true;
+}
+
+bool Filter::parseOr( char const ** ppText ) {
+  Node node;
+  memset( & node, 0, sizeof node );
+  node.op = OR;
+  if ( !parseAnd( ppText ) ) {
+    return false;
+  }
+  while ( isWord( ppText, "or" ) ) {
+    if ( !parseAnd( ppText )  ||  !push( node ) ) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool Filter::parseAnd( char const ** ppText ) {
+  Node node;
+  memset( & node, 0, sizeof node );
+  node.op = AND;
+  if ( !parseNot( ppText ) ) {
+    return false;
+  }
+  while ( isWord( ppText, "and" ) ) {
+    if ( !parseNot( ppText )  ||  !push( node ) ) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool Filter::parseNot( char const ** ppText ) {
+  Node node;
+  memset( & node, 0, sizeof node );
+  node.op = NOT;
+  if ( isWord( ppText, "not" ) ) {
+    return parseNot( ppText )  &&  push( node );
+  }
+  *ppText = skip( *ppText );
+  if ( **ppText == '(' ) {
+    (*ppText)++;
+    if ( !parseOr( ppText ) ) {
+      return false;
+    }
+    *ppText = skip( *ppText );
+    if ( **ppText != ')' ) {
+      return fail( *ppText, "missing ')'" );
+    }
+    (*ppText)++;
+    return true;
+  }
+  return parseCompare( ppText );
+}
+
+bool Filter::parseCompare( char const ** ppText ) {
+  static char const * const ops[] = { "==", "!=", "<>", "<=", ">=", "=", "<", ">" };
+  static Op           const codes[] = { EQ,   NE,   NE,   LE,   GE,   EQ,  LT,  GT  };
+  Node         node;
+  char const * pText = skip( *ppText );
+  size_t       length = token( pText ),
+               index;
+  memset( & node, 0, sizeof node );
+
+  Field const * pField = 0;
+  for ( index = 0;  index < COUNT_OF( fields );  index++ ) {
+    if ( strlen( fields[ index ].pName ) == length ) {
+      char work[ 16 ];
+      for ( size_t at = 0;  at < length;  at++ ) {
+        work[ at ] = tolower( pText[ at ] );
+      }
+      if ( memcmp( work, fields[ index ].pName, length ) == 0 ) {
+        pField = & fields[ index ];
+      }
+    }
+  }
+  if ( pField == 0 ) {
+    return fail( pText, length ? "unknown field" : "missing field" );
+  }
+  node.column = pField->column;
+  pText = skip( pText + length );
+  for ( index = 0;  index < COUNT_OF( ops );  index++ ) {
+    if ( strncmp( pText, ops[ index ], strlen( ops[ index ] ) ) == 0 ) {
+      break;
+    }
+  }
+  if ( index == COUNT_OF( ops ) ) {
+    return fail( pText, "missing comparison" );
+  }
+  node.op = codes[ index ];
+  pText   = skip( pText + strlen( ops[ index ] ) );
+
+  if ( *pText == '"'  ||  *pText == '\'' ) {   // quoted text
+    char const * pEnd = strchr( pText + 1, *pText );
+    if ( pEnd == 0 ) {
+      return fail( pText, "unterminated text" );
+    }
+    if ( pField->kind != TEXT  &&  pField->kind != LABEL  &&  pField->kind != LETTER ) {
+      return fail( pText, "text for a numeric field" );
+    }
+    if ( (size_t)(pEnd - pText - 1) >= TEXT_SIZE ) {
+      return fail( pText, "text too long" );
+    }
+    memcpy( node.text, pText + 1, pEnd - pText - 1 );
+    pText = pEnd + 1;
+  } else {
+    length = token( pText );
+    if ( length == 0 ) {
+      return fail( pText, "missing value" );
+    }
+    if ( length >= TEXT_SIZE ) {
+      return fail( pText, "value too long" );
+    }
+    memcpy( node.text, pText, length );
+    pText += length;
+  }
+  for ( length = strlen( node.text );  length > 0  &&  node.text[ length - 1 ] == ' ';  length-- ) {
+    node.text[ length - 1 ] = 0;        // as text columns are compared
+  }
+  if ( (pField->kind == TEXT  ||  (pField->kind == LABEL  &&  !isdigit( node.text[ 0 ] )))
+      &&  node.op != EQ  &&  node.op != NE ) {
+    return fail( *ppText, "text compares only with = or !=" );
+  }
+
+  if ( pField->kind == LETTER  &&  !isdigit( node.text[ 0 ] ) ) {
+    if ( !isalpha( node.text[ 0 ] )  ||  node.text[ 1 ] != 0 ) {
+      return fail( *ppText, "invalid bank letter" );
+    }
+    node.value     = toupper( node.text[ 0 ] ) - 'A';
+    node.text[ 0 ] = 0;
+  } else if ( pField->kind != TEXT  &&  (pField->kind != LABEL  ||  isdigit( node.text[ 0 ] )) ) {
+    char * pTemp;
+    double value = strtod( node.text, & pTemp ),
+           scale = pField->kind == FREQUENCY ? 1e6 : pField->kind == STEP ? 1e3 : pField->kind == TONE ? 10 : 1;
+    if ( pTemp == node.text ) {
+      return fail( *ppText, "invalid number" );
+    }
+    if ( pField->kind == FREQUENCY  ||  pField->kind == STEP  ||  pField->kind == TONE ) {
+      if ( stricmp( pTemp, "Hz" ) == 0 ) {
+        scale = pField->kind == TONE ? 10 : 1;
+      } else if ( stricmp( pTemp, "kHz" ) == 0  &&  pField->kind != TONE ) {
+        scale = 1e3;
+      } else if ( stricmp( pTemp, "MHz" ) == 0  &&  pField->kind != TONE ) {
+        scale = 1e6;
+      } else if ( *pTemp != 0 ) {
+        return fail( *ppText, "invalid unit" );
+      }
+    } else if ( *pTemp != 0 ) {
+      return fail( *ppText, "invalid number" );
+    }
+    value *= scale;
+    node.value   = (uint32_t)(int32_t)(value < 0 ? value - 0.5 : value + 0.5);
+    node.text[ 0 ] = 0;
+  }
+  *ppText = pText;
+  return push( node );
+}
+
+void Filter::evaluate( Node const & node, uint8_t * pFlags ) {
+  size_t const rows = frame.getRows();
+  ChannelFrame::Column column = (ChannelFrame::Column)node.column;
+
+  if ( node.column >= ChannelFrame::NAME  &&  node.column != CHANNEL ) {   // text
+    char const * pText  = frame.getText( column );
+    size_t       width  = column == ChannelFrame::NAME ? (size_t)ChannelFrame::NAME_SIZE : (size_t)ChannelFrame::CALL_SIZE,
+                 size   = column == ChannelFrame::NAME ? frame.getNameSize() : width,
+                 length = strlen( node.text );
+    if ( pText == 0 ) {
+      memset( pFlags, 0, rows );
+      return;
+    }
+    for ( size_t row = 0;  row < rows;  row++, pText += width ) {
+      size_t used = size;
+      while ( used > 0  &&  pText[ used - 1 ] == ' ' ) {
+        used--;
+      }
+      pFlags[ row ] = (used == length  &&  memcmp( pText, node.text, length ) == 0) == (node.op == EQ);
+    }
+    return;
+  }
+
+  uint32_t const * pValues = node.column == CHANNEL ? frame.getChannels() : frame.getValues( column );
+  uint32_t         value   = node.value;
+  if ( pValues == 0 ) {
+    memset( pFlags, 0, rows );
+    return;
+  }
+  if ( node.text[ 0 ] != 0 ) {                 // a label:  the model's code for it
+    size_t               count;
+    char const * const * pLabels = frame.getLabels( column, & count );
+    int                  code    = pLabels ? search( node.text, pLabels, count ) : -1;
+    if ( code < 0 ) {                          // no channel has it
+      status( "--- '%s' is not a value of that field for this radio;  no channel matches it ---\n", node.text );
+      for ( size_t row = 0;  row < rows;  row++ ) {
+        pFlags[ row ] = node.op == NE  &&  pValues[ row ] != ChannelFrame::UNKNOWN;
+      }
+      return;
+    }
+    value = code;
+  }
+  bool isSigned = column == ChannelFrame::RX_STEP_HZ  ||  column == ChannelFrame::TX_STEP_HZ;
+  for ( size_t row = 0;  row < rows;  row++ ) {
+    uint32_t item = pValues[ row ];
+    bool     isLess    = isSigned ? (int32_t)item < (int32_t)value : item < value,
+             isEqual   = item == value;
+    switch ( node.op ) {
+      case EQ:  pFlags[ row ] =  isEqual;             break;
+      case NE:  pFlags[ row ] = !isEqual;             break;
+      case LT:  pFlags[ row ] =  isLess;              break;
+      case LE:  pFlags[ row ] =  isLess  ||  isEqual; break;
+      case GT:  pFlags[ row ] = !isLess  && !isEqual; break;
+      case GE:  pFlags[ row ] = !isLess;              break;
+      default:  pFlags[ row ] =  0;                   break;
+    }
+    pFlags[ row ] &= item != ChannelFrame::UNKNOWN  ||  node.column == CHANNEL;
+  }
+}
+
+uint8_t const * Filter::select( Radio const * pRadio ) {
+  uint8_t * stack[ MAX_NODES ];
+  size_t    depth = 0;
+
+  uint32_t wanted = 0;                      // decode only the columns the program tests
+  for ( size_t index = 0;  index < nodes;  index++ ) {
+    if ( program[ index ].op < AND  &&  program[ index ].column != CHANNEL ) {
+      wanted |= 1 << program[ index ].column;
+    }
+  }
+  frame.decode( pRadio, wanted );
+  flags.reset();
+  size_t const rows = frame.getRows();
+  for ( size_t index = 0;  index < nodes;  index++ ) {
+    Node const & node = program[ index ];
+    switch ( node.op ) {
+      case AND:
+      case OR:
+        depth--;
+        for ( size_t row = 0;  row < rows;  row++ ) {
+          stack[ depth - 1 ][ row ] = node.op == AND ? stack[ depth - 1 ][ row ] & stack[ depth ][ row ]
+                                                     : stack[ depth - 1 ][ row ] | stack[ depth ][ row ];
+        }
+        break;
+      case NOT:
+        for ( size_t row = 0;  row < rows;  row++ ) {
+          stack[ depth - 1 ][ row ] ^= 1;
+        }
+        break;
+      default:
+        stack[ depth ] = (uint8_t *)flags.allocate( rows + 1 );
+        evaluate( node, stack[ depth++ ] );
+        break;
+    }
+  }
+
+  size_t    const offset  = pRadio->getOffset();
+  uint8_t * const pSelect = (uint8_t *)flags.allocate( pRadio->getCount() );
+  memset( pSelect, 0, pRadio->getCount() );
+  for ( size_t row = 0;  row < rows;  row++ ) {
+    pSelect[ frame.getChannels()[ row ] - offset ] = depth == 0  ||  stack[ 0 ][ row ];
+  }
+  return pSelect;
+}
@@ -0,0 +1,103 @@
+//==================================================================================================
+//  Filter.hpp is the channel filter class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  A --where expression, compiled to predicates over a ChannelFrame's typed
+//  columns, so that an export formats only the channels that match.  E.g.:
+//
+//      mode = DV and rx >= 430 and rx <= 450 and rpt1 != ""
+//
+//  A comparison is a field, one of = != < <= > >=, and a value;  comparisons
+//  combine with "and", "or", "not" & parentheses.  Frequencies are in MHz, and
+//  steps in kHz, unless a Hz, kHz or MHz suffix says otherwise;  tones are in
+//  Hz.  An enumerated field (mode, split, ...) compares with one of the model's
+//  CSV labels, or a code;  a label the model does not have matches no channel.
+//  The bank (or group) is a letter, A to Z, and its slot a number.  Text
+//  compares without its trailing spaces, with = and != only.  A comparison is
+//  false for a field the model does not have, or a channel whose value is
+//  unknown.  Only the columns the expression names are decoded;  each predicate
+//  runs down its column, and the results combine a column of flags at a time:
+//  no per-channel virtual calls or formatting.
+
+#ifndef FILTER_HPP
+#define FILTER_HPP
+
+#include "ChannelFrame.hpp"
+
+class Filter {
+  Filter(             Filter const & rhs );  // Intentionally not implemented
+  Filter & operator=( Filter const & rhs );  // Intentionally not implemented
+
+ public:
+  Filter( void ) : nodes( 0 ) {}
+
+  bool            compile( char const  * pExpression );   // false (with a message) if invalid
+  uint8_t const * select(  Radio const * pRadio      );   // a flag per channel index;  until the next call
+
+ private:
+  enum {
+    MAX_NODES = 64,
+    TEXT_SIZE = ChannelFrame::NAME_SIZE + 4,   // a name, its NUL & fill
+    CHANNEL   = ChannelFrame::COLUMNS          // the channel number "column"
+  };
+  enum Kind {             // of a field's values
+    FREQUENCY,            // MHz by default
+    STEP,                 // kHz by default
+    TONE,                 // Hz
+    CODE,                 // a number
+    LABEL,                // a CSV label, or a code
+    LETTER,               // A to Z, as codes 0 to 25
+    TEXT
+  };
+  enum Op {               // a node:  a comparison, or an operator on the flags before it
+    EQ,
+    NE,
+    LT,
+    LE,
+    GT,
+    GE,
+    AND,
+    OR,
+    NOT
+  };
+  struct Node {
+    Op       op;
+    int      column;      // a ChannelFrame::Column, or CHANNEL
+    uint32_t value;       // numeric comparisons
+    char     text[ TEXT_SIZE ];   // text comparisons;  for a LABEL, "" once it is a code
+  };
+  struct Field {
+    char const * pName;
+    int          column;
+    Kind         kind;
+  };
+  static Field const fields[];
+
+  Node         program[ MAX_NODES ];   // postfix
+  size_t       nodes;
+  ChannelFrame frame;
+  Arena        flags;
+
+  bool   parseOr(      char const ** ppText );
+  bool   parseAnd(     char const ** ppText );
+  bool   parseNot(     char const ** ppText );
+  bool   parseCompare( char const ** ppText );
+  bool   push(         Node const  & node   );
+  void   evaluate(     Node const  & node, uint8_t * pFlags );
+};
+
+#endif
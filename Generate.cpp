@@ -0,0 +1,239 @@
+//==================================================================================================
+//  Generate.cpp is the synthetic image generator class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#include "Dstar.hpp"
+#include "Generate.hpp"
+
+enum {
+  poolLimit  = 128,     // distinct values kept per field
+  valueSize  = 48
+};
+
+static struct {
+  char const * pName;
+  char const * pCode;         // ICF model code;  0 for a binary image
+  char const * pModel;        // as the model's getComment() names it, once detected
+  size_t       size;
+  size_t       lengthAt;      // offset of a little-endian 16-bit image length;  0 if none
+  size_t       blank;         // the byte value of erased memory
+  uint32_t     bands[ 2 ][ 2 ];  // kHz
+} const models[]
+    = { { "ID-1",       "25060000", "Icom ID-1",       0x013AF, 0,    0x00, { { 1240000, 1300000 }, { 1240000, 1300000 } } },
+        { "ID-800",     "27880200", "Icom ID-800H",    0x04000, 0,    0x00, { {  144000,  148000 }, {  430000,  450000 } } },
+        { "IC-91AD",    "28880000", "Icom IC-91A/D",   0x0AF90, 0,    0x00, { {  144000,  148000 }, {  430000,  450000 } } },
+        { "IC-92AD",    "30660000", "Icom IC-92AD",    0x0B9F0, 0,    0x00, { {  144000,  148000 }, {  430000,  450000 } } },
+        { "IC-80AD",    "31550001", "Icom IC-80AD",    0x0F600, 0,    0x00, { {  144000,  148000 }, {  430000,  450000 } } },
+        { "ID-880",     "31670001", "Icom ID-880H",    0x0F600, 0,    0x00, { {  144000,  148000 }, {  430000,  450000 } } },
+        { "IC-2820",    "29700001", "Icom IC-2820H",   0x0ACC0, 0,    0x00, { {  144000,  148000 }, {  430000,  450000 } } },
+        { "ID-31",      "33220001", "Icom ID-31",      0x15500, 0,    0x00, { {  430000,  450000 }, {  430000,  450000 } } },
+        { "ID-51",      "33900001", "Icom ID-51",      0x1FB40, 0,    0x00, { {  144000,  148000 }, {  430000,  450000 } } },
+        { "ID-51PLUS",  "33900002", "Icom ID-51+",     0x1FB40, 0,    0x00, { {  144000,  148000 }, {  430000,  450000 } } },
+        { "ID-51PLUS2", "33900003", "Icom ID-51++",    0x1FB40, 0,    0x00, { {  144000,  148000 }, {  430000,  450000 } } },
+        { "ID-5100",    "34840001", "Icom ID-5100",    0x2A380, 0,    0x00, { {  144000,  148000 }, {  430000,  450000 } } },
+        { "IC-7300",    0,          "Icom IC-7300",    0x01A84, 0x10, 0x00, { {    1800,   29700 }, {   50000,   54000 } } },
+        { "TH-D74",     0,          "Kenwood TH-D74",  0x7A400, 0,    0xFF, { {  144000,  148000 }, {  430000,  450000 } } } };
+
+static char const * const names[]   = { "Simplex",     "Calling",   "Club Net",  "Lookout Mtn",
+                                        "Weather",     "ARES",      "Skywarn",   "Hilltop",
+                                        "Fox Hunt",    "Airport",   "Satellite", "Net Control",
+                                        "Emergency",   "Fire Disp", "Marine 16", "County EOC" };
+static char const * const calls[]   = { "CQCQCQ",      "W7ABC",     "W7ABC  B",  "W7ABC  G",
+                                        "KE7XYZ C",    "N7DEF  A",  "K7GHI  B",  "AE7Q" };
+static char const * const offsets[] = { "0.000000",    "0.600000",  "1.600000",  "5.000000" };
+
+static uint32_t nextRandom( uint32_t * pState ) {  // xorshift32;  never returns 0 from a non-zero state
+  *pState ^= *pState << 13;
+  *pState ^= *pState >> 17;
+  *pState ^= *pState <<  5;
+  return *pState;
+}
+
+static bool isFrequency( char const * pValue ) {  // exported as "%.6f" MHz
+  char const * pDot = strchr( pValue, '.' );
+  return pDot != 0  &&  pDot > pValue  &&  strspn( pValue, "0123456789" ) == (size_t)(pDot - pValue)
+                    &&  strspn( pDot + 1, "0123456789" ) == 6  &&  pDot[ 7 ] == 0;
+}
+
+size_t Generate::count( void ) {
+  return COUNT_OF( models );
+}
+
+char const * Generate::name( size_t model ) {
+  return models[ model ].pName;
+}
+
+int Generate::find( char const * pName ) {
+  for ( size_t model = 0;  model < COUNT_OF( models );  model++ ) {
+    if ( stricmp( pName, models[ model ].pName ) == 0 ) {
+      return (int)model;
+    }
+  }
+  return -1;
+}
+
+bool Generate::isBinary( size_t model ) {
+  return models[ model ].pCode == 0;
+}
+
+// Every string a field might accept:  the radio's own choice tables, plus small numbers & words.
+char ** Generate::vocabulary( Radio const * pRadio, size_t * pCount ) {
+  static char const * const words[] = { "Off", "On", "High", "Mid", "Low" };
+  char                   ** pWords  = (char **)malloc( 512 * sizeof pWords[ 0 ] );
+  char                      work[ valueSize ];
+  size_t                    count   = 0,
+                            size;
+
+#define ADD_WORDS( TABLE, SIZE, FORMAT )                                  \
+  for ( size_t index = 0;  index < SIZE  &&  count < 512;  index++ ) {    \
+    sprintf( work, FORMAT, TABLE[ index ] );                              \
+    pWords[ count++ ] = strdup( work );                                   \
+  }
+  char const * const * pStrings  = pRadio->getSplits(      & size );  ADD_WORDS( pStrings, size, "%s" );
+  pStrings = pRadio->getModulations( & size );                         ADD_WORDS( pStrings, size, "%s" );
+  pStrings = pRadio->getFmSquelches( & size );                         ADD_WORDS( pStrings, size, "%s" );
+  pStrings = pRadio->getDcsReverses( & size );                         ADD_WORDS( pStrings, size, "%s" );
+  ADD_WORDS( Radio::skipModes,  COUNT_OF( Radio::skipModes  ), "%s" );
+  ADD_WORDS( Dstar::dvSquelches, COUNT_OF( Dstar::dvSquelches ), "%s" );
+  ADD_WORDS( words,             COUNT_OF( words ),             "%s" );
+  double   const * pDoubles = pRadio->getTuneSteps(  & size );         ADD_WORDS( pDoubles, size, "%gkHz" );
+  pDoubles = pRadio->getCtcssCodes( & size );                          ADD_WORDS( pDoubles, size, "%.1fHz" );
+  uint16_t const * pCodes   = pRadio->getDcsCodes(   & size );         ADD_WORDS( pCodes,   size, "%03d" );
+#undef  ADD_WORDS
+  for ( int number = 0;  number < 100  &&  count < 510;  number++ ) {
+    sprintf( work, "%d", number );
+    pWords[ count++ ] = strdup( work );
+    sprintf( work, "%02d", number );
+    pWords[ count++ ] = strdup( work );
+  }
+  for ( char letter = 'A';  letter <= 'Z'  &&  count < 512;  letter++ ) {
+    sprintf( work, "%c", letter );
+    pWords[ count++ ] = strdup( work );
+  }
+  *pCount = count;
+  return pWords;
+}
+
+Radio * Generate::image( size_t     model,
+                         uint32_t   seed,
+                         size_t   * pChannels ) {
+  char      header[ 80 ] = "";
+  size_t    size         = models[ model ].size;
+  uint8_t * pData        = (uint8_t *)memset( malloc( size ), (int)models[ model ].blank, size );
+  uint32_t  state        = seed * 2654435761u + 1;   // any seed, including 0, gives a non-zero state
+
+  if ( !isBinary( model ) ) {
+    sprintf( header, "%s\r\n#Comment=\r\n#MapRev=1\r\n", models[ model ].pCode );
+  }
+  if ( models[ model ].lengthAt != 0 ) {
+    pData[ models[ model ].lengthAt     ] = (uint8_t)size;
+    pData[ models[ model ].lengthAt + 1 ] = (uint8_t)(size >> CHAR_BIT);
+  }
+  quietDepth++;                                      // no "found" & "updated" lines
+  Radio * pRadio  = Radio::create( header, pData, size, isBinary( model ) );
+  char    found[ 256 ];
+  free( pData );
+  if ( pRadio != 0  &&  strcmp( pRadio->getComment( found ), models[ model ].pModel ) != 0 ) {
+    fprintf( stderr, "*** Generated %s image detected as %s ***\n", models[ model ].pName, pRadio->getComment( found ) );
+    delete pRadio;
+    pRadio = 0;
+  }
+  if ( pRadio == 0 ) {
+    quietDepth--;
+    return 0;
+  }
+
+  // A field's pool holds each vocabulary word that it accepts & exports unchanged;  the
+  // probing is done on the last channel, which is then generated like any other.
+  CsvField const * const csvField = pRadio->csvHeader();
+  size_t                 fieldCount,
+                         wordCount,
+                         channels = pRadio->getCount();
+  char                ** pWords   = vocabulary( pRadio, & wordCount );
+  for ( fieldCount = 0;  csvField[ fieldCount ].fieldName != 0;  fieldCount++ );
+  char   (* pPools)[ poolLimit ][ valueSize ] = (char (*)[ poolLimit ][ valueSize ])
+                                               malloc( fieldCount * sizeof *pPools );
+  size_t  * pPoolSizes   = (size_t *)calloc( fieldCount, sizeof pPoolSizes[ 0 ] );
+  bool    * pFrequencies = (bool   *)calloc( fieldCount, sizeof pFrequencies[ 0 ] );
+  char      work[ 1024 ];
+  (pRadio->*csvField[ 0 ].setField)( channels - 1, "1" );
+  for ( size_t field = 1;  field < fieldCount;  field++ ) {
+    pFrequencies[ field ] = (pRadio->*csvField[ field ].getField)( channels - 1, work )  &&  isFrequency( work );
+    for ( size_t word = 0;  word < wordCount  &&  pPoolSizes[ field ] < poolLimit;  word++ ) {
+      if ( pWords[ word ][ 0 ] != '?'       // "?5?" marks an unused code
+          &&  (pRadio->*csvField[ field ].setField)( channels - 1, pWords[ word ] )
+          &&  (pRadio->*csvField[ field ].getField)( channels - 1, work )
+          &&  strcmp( work, pWords[ word ] ) == 0 ) {
+        size_t value = 0;
+        for (  ;  value < pPoolSizes[ field ]  &&  strcmp( work, pPools[ field ][ value ] ) != 0;  value++ );
+        if ( value == pPoolSizes[ field ] ) {
+          strcpy( pPools[ field ][ pPoolSizes[ field ]++ ], work );
+        }
+      }
+    }
+  }
+  for ( size_t word = 0;  word < wordCount;  word++ ) {
+    free( pWords[ word ] );
+  }
+  free( pWords );
+
+  for ( size_t channel = 0;  channel < channels;  channel++ ) {
+    (pRadio->*csvField[ 0 ].setField)( channel, "1" );
+    for ( size_t field = 1;  field < fieldCount;  field++ ) {
+      char const * pField = csvField[ field ].fieldName;
+      for ( int attempt = 0;  attempt < 4;  attempt++ ) {
+        uint32_t pick = nextRandom( & state );
+        if ( strstr( pField, "Name" ) != 0 ) {    // some radios have upper case, 6-character names
+          strcpy( work, names[ pick % COUNT_OF( names ) ] );
+          for ( char * pNext = work;  attempt > 0  &&  *pNext != 0;  pNext++ ) {
+            *pNext = (char)toupper( *pNext );
+          }
+          work[ attempt > 1 ? 6 : valueSize - 1 ] = 0;
+        } else if ( strstr( pField, "Call" ) != 0 ) {
+          strcpy( work, calls[ pick % COUNT_OF( calls ) ] );
+        } else if ( pFrequencies[ field ]  &&  strstr( pField, "Offset" ) != 0 ) {
+          strcpy( work, offsets[ pick % COUNT_OF( offsets ) ] );
+        } else if ( pFrequencies[ field ] ) {
+          uint32_t const * pBand = models[ model ].bands[ pick & 1 ];
+          uint32_t         kHz   = pBand[ 0 ] + (pick >> 1) % ((pBand[ 1 ] - pBand[ 0 ]) / 5) * 5;
+          sprintf( work, "%u.%03u000", (unsigned)(kHz / 1000), (unsigned)(kHz % 1000) );
+        } else if ( pPoolSizes[ field ] > 0 ) {
+          strcpy( work, pPools[ field ][ pick % pPoolSizes[ field ] ] );
+        } else {
+          break;
+        }
+        char check[ 1024 ];
+        if ( (pRadio->*csvField[ field ].setField)( channel, work )
+            &&  (pRadio->*csvField[ field ].getField)( channel, check )
+            &&  strncmp( & check[ check[ 0 ] == '"' ], work, strlen( work ) ) == 0 ) {
+          break;
+        }
+      }
+    }
+  }
+  free( pPools );
+  free( pPoolSizes );
+  free( pFrequencies );
+  quietDepth--;
+  if ( pChannels != 0 ) {                             // those in use, not the slots
+    *pChannels = 0;
+    for ( size_t channel = 0;  channel < channels;  channel++ ) {
+      *pChannels += pRadio->getValid( channel );
+    }
+  }
+  return pRadio;
+}
@@ -0,0 +1,46 @@
+//==================================================================================================
+//  Generate.hpp is the synthetic image generator class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Generates a fully populated, reproducible image for any registered model:
+//  the same model & seed always give the same image.  Every channel is valid.
+//  Frequencies, offsets, names & call signs are made up to look like a real
+//  radio;  every other field takes values that the model's own CSV export
+//  produced from a (seeded) random scratch image, so no per-model tables are
+//  needed here beyond the image size, file header & bands.
+
+#ifndef GENERATE_HPP
+#define GENERATE_HPP
+
+#include "Radio.hpp"
+
+class Generate {
+  Generate(             void                 );  // Intentionally not implemented
+  Generate(             Generate const & rhs );  // Intentionally not implemented
+  Generate & operator=( Generate const & rhs );  // Intentionally not implemented
+
+  static char      ** vocabulary( Radio const * pRadio, size_t * pCount );
+
+ public:
+  static size_t       count(    void                                                        );
+  static char const * name(     size_t       model                                          );
+  static int          find(     char const * pName                                          );
+  static bool         isBinary( size_t       model                                          );
+  static Radio      * image(    size_t       model, uint32_t seed, size_t * pChannels = 0   );  // in use
+};
+
+#endif
@@ -0,0 +1,140 @@
+//==================================================================================================
+//  Hash.cpp is the hashing class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#include "Hash.hpp"
+
+static uint32_t const roundConstants[ 64 ]
+    = { 0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+        0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+        0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+        0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+        0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+        0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+        0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+        0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2 };
+
+static inline uint32_t rotate( uint32_t value, int count ) {
+  return (value >> count) | (value << (32 - count));
+}
+
+Sha256::Sha256( void ) : length( 0 ) {
+  state[ 0 ] = 0x6A09E667;
+  state[ 1 ] = 0xBB67AE85;
+  state[ 2 ] = 0x3C6EF372;
+  state[ 3 ] = 0xA54FF53A;
+  state[ 4 ] = 0x510E527F;
+  state[ 5 ] = 0x9B05688C;
+  state[ 6 ] = 0x1F83D9AB;
+  state[ 7 ] = 0x5BE0CD19;
+}
+
+void Sha256::transform( uint8_t const * pBlock ) {
+  uint32_t schedule[ 64 ],
+           work[      8 ];
+  size_t   index;
+
+  for ( index = 0;  index < 16;  index++, pBlock += 4 ) {
+    schedule[ index ] = (uint32_t)pBlock[ 0 ] << 24 | (uint32_t)pBlock[ 1 ] << 16
+                      | (uint32_t)pBlock[ 2 ] <<  8 | (uint32_t)pBlock[ 3 ];
+  }
+  for (  ;  index < 64;  index++ ) {
+    uint32_t s0 = rotate( schedule[ index - 15 ],  7 ) ^ rotate( schedule[ index - 15 ], 18 ) ^ (schedule[ index - 15 ] >>  3);
+    uint32_t s1 = rotate( schedule[ index -  2 ], 17 ) ^ rotate( schedule[ index -  2 ], 19 ) ^ (schedule[ index -  2 ] >> 10);
+    schedule[ index ] = schedule[ index - 16 ] + s0 + schedule[ index - 7 ] + s1;
+  }
+  memcpy( work, state, sizeof work );
+  for ( index = 0;  index < 64;  index++ ) {
+    uint32_t s1 = rotate( work[ 4 ], 6 ) ^ rotate( work[ 4 ], 11 ) ^ rotate( work[ 4 ], 25 );
+    uint32_t t1 = work[ 7 ] + s1 + ((work[ 4 ] & work[ 5 ]) ^ (~work[ 4 ] & work[ 6 ]))
+                + roundConstants[ index ] + schedule[ index ];
+    uint32_t s0 = rotate( work[ 0 ], 2 ) ^ rotate( work[ 0 ], 13 ) ^ rotate( work[ 0 ], 22 );
+    uint32_t t2 = s0 + ((work[ 0 ] & work[ 1 ]) ^ (work[ 0 ] & work[ 2 ]) ^ (work[ 1 ] & work[ 2 ]));
+    memmove( & work[ 1 ], & work[ 0 ], 7 * sizeof work[ 0 ] );
+    work[ 4 ] += t1;
+    work[ 0 ]  = t1 + t2;
+  }
+  for ( index = 0;  index < 8;  index++ ) {
+    state[ index ] += work[ index ];
+  }
+}
+
+void Sha256::update( void const * pBytes, size_t count ) {
+  uint8_t const * pNext = (uint8_t const *)pBytes;
+  size_t          used  = length % sizeof block;
+
+  length += count;
+  if ( used > 0 ) {
+    size_t part = sizeof block - used < count ? sizeof block - used : count;
+    memcpy( & block[ used ], pNext, part );
+    pNext += part;
+    count -= part;
+    if ( used + part < sizeof block ) {
+      return;
+    }
+    transform( block );
+  }
+  for (  ;  count >= sizeof block;  pNext += sizeof block, count -= sizeof block ) {
+    transform( pNext );
+  }
+  memcpy( block, pNext, count );
+}
+
+void Sha256::final( uint8_t * pDigest ) {
+  uint64_t bits = length * CHAR_BIT;
+  size_t   used = length % sizeof block;
+
+  block[ used++ ] = 0x80;
+  if ( used > sizeof block - sizeof bits ) {
+    memset( & block[ used ], 0, sizeof block - used );
+    transform( block );
+    used = 0;
+  }
+  memset( & block[ used ], 0, sizeof block - sizeof bits - used );
+  for ( size_t index = sizeof block;  index-- > sizeof block - sizeof bits;  bits >>= CHAR_BIT ) {
+    block[ index ] = (uint8_t)bits;
+  }
+  transform( block );
+  for ( size_t index = 0;  index < DIGEST_SIZE;  index++ ) {
+    pDigest[ index ] = (uint8_t)(state[ index / 4 ] >> (24 - index % 4 * 8));
+  }
+}
+
+void Sha256::hash( void const * pBytes, size_t count, uint8_t * pDigest ) {
+  Sha256 sha256;
+  sha256.update( pBytes, count );
+  sha256.final(  pDigest );
+}
+
+void Sha256::hex( uint8_t const * pDigest, char * pHex ) {
+  for ( size_t index = 0;  index < DIGEST_SIZE;  index++ ) {
+    sprintf( & pHex[ index * 2 ], "%02x", pDigest[ index ] );
+  }
+}
+
+bool Sha256::unhex( char const * pHex, uint8_t * pDigest ) {
+  char work[ 3 ] = { 0 };
+  for ( size_t index = 0;  index < DIGEST_SIZE;  index++ ) {
+    if ( !isxdigit( pHex[ index * 2 ] )  ||  !isxdigit( pHex[ index * 2 + 1 ] ) ) {
+      return false;
+    }
+    work[ 0 ] = pHex[ index * 2 ];
+    work[ 1 ] = pHex[ index * 2 + 1 ];
+    pDigest[ index ] = (uint8_t)strtoul( work, 0, 0x10 );
+  }
+  return pHex[ DIGEST_SIZE * 2 ] == 0;
+}
@@ -0,0 +1,48 @@
+//==================================================================================================
+//  Hash.hpp is the hashing class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#ifndef HASH_HPP
+#define HASH_HPP
+
+#include "Radio.hpp"
+
+class Sha256 {            // FIPS 180-4
+ public:
+  enum {
+    DIGEST_SIZE = 32,
+    HEX_SIZE    = DIGEST_SIZE * 2 + 1
+  };
+
+ private:
+  uint32_t state[  8 ];
+  uint8_t  block[ 64 ];
+  uint64_t length;
+
+  void     transform( uint8_t const * pBlock );
+
+ public:
+  Sha256( void );
+  void     update(    void const * pBytes, size_t count );
+  void     final(     uint8_t    * pDigest );
+
+  static void hash(   void const * pBytes, size_t count, uint8_t * pDigest );
+  static void hex(    uint8_t const * pDigest, char * pHex );
+  static bool unhex(  char const    * pHex,    uint8_t * pDigest );
+};
+
+#endif
@@ -118,6 +118,15 @@ class Ic2820 : public Dstar {
   virtual size_t               getCount(        void                                 ) const {
     return Ic2820Memory::CHANNELS;
   }
+  virtual ImageRegion const  * getRegions(      size_t * count                       ) const {
+    static ImageRegion const regions[] = { REGION( channel ), REGION( scanEdge ), REGION( call ),
+                                           REGION( ignoreChannel ), REGION( fill1 ), REGION( skipChannel ),
+                                           REGION( skippChannel ), REGION( bankMap ), REGION( fill2 ),
+                                           REGION( comment ), REGION( myCall ), REGION( urCall ),
+                                           REGION( rpCall ), REGION( fill9 ) };
+    *count = COUNT_OF( regions );
+    return regions;
+  }
 
   virtual bool                 getValid(        size_t   index                       ) const {
     return !getIgnore( index );
@@ -132,6 +141,12 @@ class Ic2820 : public Dstar {
     pMemory->channel[ index ].direction = 0;
     setIgnore( index, !value );
   }
+  virtual bool                 swapChannels(    size_t   a,     size_t       b       ) {
+    swapBytes( & pMemory->channel[ a ], & pMemory->channel[ b ], sizeof pMemory->channel[ 0 ] );
+    swapBytes( & pMemory->bankMap[ a ], & pMemory->bankMap[ b ], sizeof pMemory->bankMap[ 0 ] );
+    swapFlags( a, b );
+    return true;
+  }
 
   virtual uint32_t             getRxFreq(       size_t   index                       ) const {
     return pMemory->channel[ index ].rxFreq.hz();
@@ -311,7 +326,8 @@ class Ic2820 : public Dstar {
 
 Dstar * newIc2820( char    const * pHeader,
                    uint8_t const * pData,
-                   size_t          size ) {
+                   size_t          size,
+                   Radio         * pIdle ) {
   return size == sizeof( Ic2820Memory )  &&  memcmp( pHeader, "29700001", 8 ) == 0
-         ? new Ic2820( pHeader, pData, size ) : 0;
+         ? reuse< Ic2820 >( pIdle, pHeader, pData, size ) : 0;
 }
@@ -16,7 +16,7 @@
 //  with this program; if not, write to the Free Software Foundation, Inc.,
 //  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
-#include "Radio.hpp"
+#include "Stats.hpp"
 
 static char const * const modulations[] = { "LSB", "LSB-D",    "USB", "USB-D", "CW",  "?2?", "CW-R",   "?3", 
                                            "RTTY",   "?4?", "RTTY-R",   "?5?", "AM", "AM-D",   "FM", "FM-D" };
@@ -145,12 +145,33 @@ class Ic7300 : public Radio {
   virtual size_t               getOffset(      void                                  ) const {
     return 1;
   }
+  virtual ImageRegion const  * getRegions(     size_t * count                        ) const {
+    static ImageRegion const regions[] = { REGION( header ), REGION( lengthLE ), REGION( channel ),
+                                           REGION( lowerScanEdge ), REGION( upperScanEdge ),
+                                           REGION( dummy1 ), REGION( isValid ), REGION( scan ),
+                                           REGION( dummy2 ), REGION( stack160m ), REGION( stack80m ),
+                                           REGION( stack40m ), REGION( stack30m ), REGION( stack20m ),
+                                           REGION( stack17m ), REGION( stack15m ), REGION( stack12m ),
+                                           REGION( stack10m ), REGION( stack6m ), REGION( stackGen ),
+                                           REGION( dummy3 ), REGION( mpad ), REGION( cwMessages ),
+                                           REGION( rttyMessages ), REGION( dummy4 ), REGION( callsign ),
+                                           REGION( dummy5 ), REGION( scopeEdge03_16 ),
+                                           REGION( scopeEdge16_20 ), REGION( scopeEdge02_06 ),
+                                           REGION( scopeEdge06_08 ), REGION( scopeEdge08_11 ),
+                                           REGION( scopeEdge11_15 ), REGION( scopeEdge15_20 ),
+                                           REGION( scopeEdge20_22 ), REGION( scopeEdge22_26 ),
+                                           REGION( scopeEdge26_30 ), REGION( scopeEdge30_45 ),
+                                           REGION( scopeEdge45_60 ), REGION( scopeEdge60_75 ),
+                                           REGION( dummy6 ), REGION( checkSumLE ), REGION( zero9 ) };
+    *count = COUNT_OF( regions );
+    return regions;
+  }
 
   virtual bits_t               getSplit(       size_t   index               ) const { assert( false ); return 0; }
   virtual bool                 setSplit(       size_t   index, bits_t value )       { assert( false ); return 0; }
   virtual bits_t               getRxStep(      size_t   index               ) const { assert( false ); return 0; }
   virtual bool                 setRxStep(      size_t   index, bits_t value )       { assert( false ); return 0; }
-  virtual double const       * getTuneSteps(   size_t * count               ) const { assert( false ); return 0; }
+  virtual double const       * getTuneSteps(   size_t * count               ) const { *count = 0;  return 0; }
   virtual bits_t               getDcsCode(     size_t   index               ) const { assert( false ); return 0; }
   virtual bool                 setDcsCode(     size_t   index, bits_t value )       { assert( false ); return 0; }
   virtual bits_t               getDcsReverse(  size_t   index               ) const { assert( false ); return 0; }
@@ -168,6 +189,14 @@ class Ic7300 : public Radio {
     memcpy( & pMemory->channel[ index ], & pMemory->lowerScanEdge, sizeof pMemory->channel[ 0 ] );
     setName( index, "" );
   }
+  virtual bool                 swapChannels(   size_t   a,     size_t       b       ) {
+    bits_t scan = getScan( a );
+    swapBytes( & pMemory->channel[ a ], & pMemory->channel[ b ], sizeof pMemory->channel[ 0 ] );
+    swapBits( pMemory->isValid, a, b );
+    setScan( a, getScan( b ) );
+    setScan( b, scan );
+    return true;
+  }
 
   virtual char const         * getName(        size_t   index, size_t     * pSize   ) const {
     *pSize = sizeof pMemory->channel[ 0 ].name;
@@ -240,6 +269,10 @@ class Ic7300 : public Radio {
     }
     return setScan( index, result );
   }
+  virtual CsvField::Type       getFieldType(   getField_t getField, size_t * pWidth ) const {
+    return getField == reinterpret_cast< getField_t >( & Ic7300::_getScan ) ? CsvField::WHOLE
+                                                                             : Radio::getFieldType( getField, pWidth );
+  }
 
   virtual bits_t               getFmSquelch(   size_t   index                       ) const {
     return pMemory->channel[ index ].rx.fmSquelch;
@@ -272,7 +305,8 @@ class Ic7300 : public Radio {
     return true;
   }
 
-  virtual void save( FILE * pFile, bool isBinary, char const * pComment ) {
+  virtual void save( Output & output, bool isBinary, char const * pComment ) {
+    Stats::Span  span( Stats::SAVE );
     char const * pModel = setComment( pComment );
     Endian16 checkSum = { 0 };
     for ( uint8_t * pSum  = pMemory->lengthLE + sizeof pMemory->lengthLE;
@@ -280,8 +314,9 @@ class Ic7300 : public Radio {
           checkSum.value  -= *pSum++ );
     pMemory->checkSumLE[ 0 ] = checkSum.byte.lowest;
     pMemory->checkSumLE[ 1 ] = checkSum.byte.highest;
-    fwrite( pData, 1, size, pFile );
-    fprintf( stderr, "--- %s updated ---\n", pModel );
+    output.write( pData, size );
+    Stats::add( Stats::BYTES_OUT, size );
+    status( "--- %s updated ---\n", pModel );
   }
 
  public:
@@ -327,10 +362,11 @@ CsvField const Ic7300::csvFields[]
 
 Radio * newIc7300( char    const * pHeader,
                    uint8_t const * pData,
-                   size_t          size ) {
+                   size_t          size,
+                   Radio         * pIdle ) {
   Endian16  length;
   length.byte.lowest  = ((Ic7300Memory *)pData)->lengthLE[ 0 ];
   length.byte.highest = ((Ic7300Memory *)pData)->lengthLE[ 1 ];
   return size == sizeof( Ic7300Memory )  &&  size == length.value
-         ? new Ic7300( pHeader, pData, size ) : 0;
+         ? reuse< Ic7300 >( pIdle, pHeader, pData, size ) : 0;
 }
@@ -132,6 +132,17 @@ class Ic9Xd : public Dstar {
   virtual size_t               getCount(        void                                 ) const {
     return Ic9XdMemory::A_CHANNELS + Ic9XdMemory::B_CHANNELS;
   }
+  virtual ImageRegion const  * getRegions(      size_t * count                       ) const {
+    static ImageRegion const regions[] = { REGION( channelA ), REGION( scanEdgeA ), REGION( channelB ),
+                                           REGION( scanEdgeB ), REGION( fill1 ), REGION( ignoreChannelA ),
+                                           REGION( skipChannelA ), REGION( skippChannelA ),
+                                           REGION( ignoreChannelB ), REGION( skipChannelB ),
+                                           REGION( skippChannelB ), REGION( fill2 ), REGION( bankMapA ),
+                                           REGION( bankMapB ), REGION( fill3 ), REGION( myCall ),
+                                           REGION( urCall ), REGION( rpCall ) };
+    *count = COUNT_OF( regions );
+    return regions;
+  }
 
   virtual bool                 getValid(        size_t   index                       ) const {
     return !getIgnore( index );
@@ -145,6 +156,19 @@ class Ic9Xd : public Dstar {
     getChannel( index )->unknown1 = 0xE4;
     setIgnore( index, !value );
   }
+  virtual bool                 swapChannels(    size_t   a,     size_t       b       ) {
+    if ( getSection( a ) != getSection( b ) ) {
+      return false;
+    }
+    swapBytes( getChannel( a ), getChannel( b ), a < Ic9XdMemory::A_CHANNELS ? sizeof pMemory->channelA[ 0 ]
+                                                                             : sizeof pMemory->channelB[ 0 ] );
+    swapBytes( getBankMap( a ), getBankMap( b ), sizeof( BankMap ) );
+    swapFlags( a, b );
+    return true;
+  }
+  virtual size_t               getSection(      size_t   index                       ) const {
+    return index < Ic9XdMemory::A_CHANNELS ? 0 : 1;
+  }
 
   virtual uint32_t             getRxFreq(       size_t   index                       ) const {
     return getChannel( index )->rxFreq.hz( divisorsX3[ getChannel( index )->rxResolution ] ) / 3;
@@ -341,7 +365,7 @@ class Ic9Xd : public Dstar {
   virtual ~Ic9Xd( void ) {}
 };
 
-char const * const Ic9Xd::modulations[] = { "FM", "FM-N", "WFM", "AM", "DV" };
+char const * const Ic9Xd::modulations[] = { "FM", "FM-N", "WFM", "AM", "DV", "?5?", "?6?", "?7?" };
 
 class Ic91d : public Ic9Xd {
   Ic91d(             void              );  // Intentionally not implemented
@@ -391,14 +415,16 @@ class Ic92d : public Ic9Xd {
 
 Dstar * newIc91d( char    const * pHeader,
                   uint8_t const * pData,
-                  size_t          size ) {
+                  size_t          size,
+                  Radio         * pIdle ) {
   return size == 0xAF90  &&  memcmp( pHeader, "28880000", 8 ) == 0
-         ? new Ic91d( pHeader, pData, size ) : 0;
+         ? reuse< Ic91d >( pIdle, pHeader, pData, size ) : 0;
 }
 
 Dstar * newIc92d( char    const * pHeader,
                   uint8_t const * pData,
-                  size_t          size ) {
+                  size_t          size,
+                  Radio         * pIdle ) {
   return size == 0xB9F0  &&  memcmp( pHeader, "30660000", 8 ) == 0
-         ? new Ic92d( pHeader, pData, size ) : 0;
+         ? reuse< Ic92d >( pIdle, pHeader, pData, size ) : 0;
 }
@@ -82,7 +82,7 @@ class Id1 : public Dstar {
 
   virtual bits_t         getRxStep(      size_t   index                       ) const { assert( false ); return 0; }
   virtual bool           setRxStep(      size_t   index, bits_t       value   )       { assert( false ); return 0; }
-  virtual double const * getTuneSteps(   size_t * count                       ) const { assert( false ); return 0; }
+  virtual double const * getTuneSteps(   size_t * count                       ) const { *count = 0;  return 0; }
   virtual bits_t         getDcsCode(     size_t   index                       ) const { assert( false ); return 0; }
   virtual bool           setDcsCode(     size_t   index, bits_t       value   )       { assert( false ); return 0; }
   virtual bits_t         getDcsReverse(  size_t   index                       ) const { assert( false ); return 0; }
@@ -103,6 +103,11 @@ class Id1 : public Dstar {
   virtual size_t               getCount(         void                                 ) const {
     return Id1Memory::CHANNELS;
   }
+  virtual ImageRegion const  * getRegions(       size_t * count                       ) const {
+    static ImageRegion const regions[] = { REGION( channel ), REGION( scanEdge ), REGION( call ) };
+    *count = COUNT_OF( regions );
+    return regions;
+  }
 
   virtual bool                 getValid(         size_t   index                       ) const {
     return pMemory->channel[ index ].rxFreq.hz() > 0;
@@ -111,6 +116,10 @@ class Id1 : public Dstar {
     memset( & pMemory->channel[ index ], value ? 0 : -1, sizeof pMemory->channel[ 0 ] );
     setName(    index, "" );
   }
+  virtual bool                 swapChannels(     size_t   a,     size_t       b       ) {
+    swapBytes( & pMemory->channel[ a ], & pMemory->channel[ b ], sizeof pMemory->channel[ 0 ] );
+    return true;
+  }
 
   virtual uint32_t             getRxFreq(        size_t   index                       ) const {
     return pMemory->channel[ index ].rxFreq.hz();
@@ -279,7 +288,8 @@ CsvField const Id1::csvFields[]
 
 Dstar * newId1( char const * pHeader,
                      uint8_t const * pData,
-                     size_t          size ) {
+                     size_t          size,
+                     Radio         * pIdle ) {
   return size == sizeof( Id1Memory ) - 1  &&  memcmp( pHeader, "25060000", 8 ) == 0
-         ? new Id1( pHeader, pData, size ) : 0;
+         ? reuse< Id1 >( pIdle, pHeader, pData, size ) : 0;
 }
@@ -117,7 +117,7 @@ class Id800 : public Dstar {
     return pMemory->suffix[ index ].ignore;
   }
   virtual bool                 setIgnore(       size_t   index, bool         value   )       {
-    pMemory->suffix[ index ].ignore = value ? 0 : 1;
+    pMemory->suffix[ index ].ignore = value ? 1 : 0;
     return true;
   }
   virtual bool                 getSkip(         size_t   index                       ) const {
@@ -149,6 +149,14 @@ class Id800 : public Dstar {
   virtual size_t               getCount(        void                               ) const {
     return Id800Memory::CHANNELS;
   }
+  virtual ImageRegion const  * getRegions(      size_t * count                     ) const {
+    static ImageRegion const regions[] = { REGION( header1 ), REGION( header2 ), REGION( channel ),
+                                           REGION( scanEdge ), REGION( suffix ), REGION( fill1 ),
+                                           REGION( myCall ), REGION( urCall ), REGION( rpCall ),
+                                           REGION( fill2 ), REGION( comment ), REGION( fill3 ) };
+    *count = COUNT_OF( regions );
+    return regions;
+  }
 
   virtual CsvField const * csvHeader( void ) const {
     return csvFields;
@@ -173,6 +181,11 @@ class Id800 : public Dstar {
     setName(   index, "" );
     setIgnore( index, !value );
   }
+  virtual bool                 swapChannels(    size_t   a,     size_t       b       ) {
+    swapBytes( & pMemory->channel[ a ], & pMemory->channel[ b ], sizeof pMemory->channel[ 0 ] );
+    swapBytes( & pMemory->suffix[  a ], & pMemory->suffix[  b ], sizeof pMemory->suffix[  0 ] );
+    return true;
+  }
 
   virtual uint32_t             getRxFreq(       size_t   index                       ) const {
     return pMemory->channel[ index ].rxFreq.hz( divisorsX3[ pMemory->channel[ index ].rxResolution ] ) / 3;
@@ -262,8 +275,10 @@ class Id800 : public Dstar {
   }
 
   virtual char const         * getName(         size_t   index, size_t     * pSize   ) const {
-    assert( false );
-    return 0;
+    static THREAD_LOCAL char work[ 8 ];   // until this thread's next call
+    getName( index )->unpack( work );
+    *pSize = 6;
+    return work;
   }
   virtual Id800Name const    * getName(         size_t   index                       ) const {
     return & pMemory->channel[ index ].name;
@@ -471,12 +486,13 @@ CsvField const Id800::csvFields[]
         { "RPT2 Call Sign",  reinterpret_cast< getField_t >( & Id800::_getRpt2Call     ),
                              reinterpret_cast< setField_t >( & Id800::_setRpt2Call     ) },
         { "Bank Group",      reinterpret_cast< getField_t >( & Id800::_getBankGroup    ),
-                             reinterpret_cast< setField_t >( & Id800::_setBankChannel  ) },
+                             reinterpret_cast< setField_t >( & Id800::_setBankGroup    ) },
         { 0, 0, 0 } };
 
 Dstar * newId800( char    const * pHeader,
                   uint8_t const * pData,
-                  size_t          size ) {
+                  size_t          size,
+                  Radio         * pIdle ) {
   return size == sizeof( Id800Memory )  &&  memcmp( pHeader, "27880200", 8 ) == 0
-         ? new Id800( pHeader, pData, size ) : 0;
+         ? reuse< Id800 >( pIdle, pHeader, pData, size ) : 0;
 }
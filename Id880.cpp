@@ -92,6 +92,16 @@ class Id8X0 : public Dstar {
   virtual size_t             getCount(        void                               ) const {
     return Id8X0Memory::CHANNELS;
   }
+  virtual ImageRegion const * getRegions(      size_t * count                     ) const {
+    static ImageRegion const regions[] = { REGION( channel ), REGION( scanEdge ), REGION( call ),
+                                           REGION( fill1 ), REGION( fill2 ), REGION( ignoreChannel ),
+                                           REGION( skipChannel ), REGION( skippChannel ), REGION( fill3 ),
+                                           REGION( bankMap ), REGION( fill4 ), REGION( comment ),
+                                           REGION( spaces ), REGION( fill5 ), REGION( fill6 ),
+                                           REGION( myCall ), REGION( fill9 ) };
+    *count = COUNT_OF( regions );
+    return regions;
+  }
 
   virtual bool               getValid(        size_t index                       ) const {
     return !getIgnore( index );
@@ -104,6 +114,12 @@ class Id8X0 : public Dstar {
     setSkipMode( index, 0 );
     setIgnore(   index, !value );
   }
+  virtual bool               swapChannels(    size_t   a,     size_t       b       ) {
+    swapBytes( & pMemory->channel[ a ], & pMemory->channel[ b ], sizeof pMemory->channel[ 0 ] );
+    swapBytes( & pMemory->bankMap[ a ], & pMemory->bankMap[ b ], sizeof pMemory->bankMap[ 0 ] );
+    swapFlags( a, b );
+    return true;
+  }
   virtual uint32_t           getRxFreq(       size_t   index                       ) const {
     return pMemory->channel[ index ].freq.rxHz();
   }
@@ -324,14 +340,16 @@ public:
 
 Dstar * newId880( char    const * pHeader,
                 uint8_t const * pData,
-                size_t          size ) {
+                size_t          size,
+                Radio         * pIdle ) {
   return size == 0xF600  &&  memcmp( pHeader, "31670001", 8 ) == 0
-         ? new Id880( pHeader, pData, size ) : 0;
+         ? reuse< Id880 >( pIdle, pHeader, pData, size ) : 0;
 }
 
 Dstar * newIc80d( char    const * pHeader,
                 uint8_t const * pData,
-                size_t          size ) {
+                size_t          size,
+                Radio         * pIdle ) {
   return size == 0xF600  &&  memcmp( pHeader, "31550001", 8 ) == 0
-         ? new Ic80d( pHeader, pData, size ) : 0;
+         ? reuse< Ic80d >( pIdle, pHeader, pData, size ) : 0;
 }
@@ -48,6 +48,11 @@ class IdDr : public Dstar {
     setSkipMode( index, 0 );
     setIgnore(   index, !value );
   }
+  virtual bool                 swapChannels(    size_t   a,     size_t       b       ) {
+    swapBytes( & pChannel[ a ], & pChannel[ b ], sizeof pChannel[ 0 ] );
+    swapFlags( a, b );
+    return true;
+  }
 
   virtual uint32_t             getRxFreq(       size_t   index                       ) const {
     return pChannel[ index ].freq.rxHz();
@@ -259,6 +264,17 @@ class Id31 : public IdDr {
   virtual size_t getCount(        void                         ) const {
     return Id31Memory::CHANNELS;
   }
+  virtual ImageRegion const * getRegions( size_t * count ) const {
+    static ImageRegion const regions[] = { REGION( channel ), REGION( scanEdge ), REGION( call ),
+                                           REGION( fill1 ), REGION( ignoreChannel ), REGION( skipChannel ),
+                                           REGION( skippChannel ), REGION( fill2 ), REGION( bankMap ),
+                                           REGION( fill3 ), REGION( comment ), REGION( bankName ),
+                                           REGION( scanName ), REGION( fill4 ), REGION( dstarRepeater ),
+                                           REGION( rpCall ), REGION( groupName ), REGION( myCall ),
+                                           REGION( urCall ), REGION( fill5 ) };
+    *count = COUNT_OF( regions );
+    return regions;
+  }
 
   virtual bool   getIgnore(       size_t   index               ) const {
     return getBit( pMemory->ignoreChannel, index );
@@ -306,6 +322,10 @@ class Id31 : public IdDr {
     pMemory->bankMap[ index ].index = value;
     return true;
   }
+  virtual bool   swapChannels(    size_t   a,     size_t b     )       {
+    swapBytes( & pMemory->bankMap[ a ], & pMemory->bankMap[ b ], sizeof pMemory->bankMap[ 0 ] );
+    return IdDr::swapChannels( a, b );
+  }
 
  public:
   Id31( char    const * pHeader,
@@ -318,9 +338,10 @@ class Id31 : public IdDr {
 
 Dstar * newId31( char    const * pHeader,
                  uint8_t const * pData,
-                 size_t          size ) {
+                 size_t          size,
+                 Radio         * pIdle ) {
   return size == sizeof( Id31Memory )  &&  memcmp( pHeader, "33220001", 8 ) == 0
-         ? new Id31( pHeader, pData, size ) : 0;
+         ? reuse< Id31 >( pIdle, pHeader, pData, size ) : 0;
 }
 
 // ==============================================================================
@@ -381,6 +402,18 @@ class Id51x : public IdDr {
   virtual size_t getCount(        void                         ) const {
     return Id51Memory::CHANNELS;
   }
+  virtual ImageRegion const * getRegions( size_t * count ) const {
+    static ImageRegion const regions[] = { REGION( channel ), REGION( scanEdge ), REGION( call ),
+                                           REGION( fill1 ), REGION( ignoreChannel ), REGION( skipChannel ),
+                                           REGION( skippChannel ), REGION( fill2 ), REGION( bankMap ),
+                                           REGION( fill3 ), REGION( comment ), REGION( bankName ),
+                                           REGION( scanName ), REGION( fill4 ), REGION( bcStation ),
+                                           REGION( fill5 ), REGION( bcBankName ), REGION( fill6 ),
+                                           REGION( dstarRepeater ), REGION( rpCall ), REGION( groupName ),
+                                           REGION( myCall ), REGION( urCall ), REGION( fill8 ) };
+    *count = COUNT_OF( regions );
+    return regions;
+  }
 
   virtual bool   getIgnore(       size_t   index               ) const {
     return getBit( pMemory->ignoreChannel, index );
@@ -428,6 +461,10 @@ class Id51x : public IdDr {
     pMemory->bankMap[ index ].index = value;
     return true;
   }
+  virtual bool   swapChannels(    size_t   a,     size_t b     )       {
+    swapBytes( & pMemory->bankMap[ a ], & pMemory->bankMap[ b ], sizeof pMemory->bankMap[ 0 ] );
+    return IdDr::swapChannels( a, b );
+  }
 
  public:
   Id51x( char    const * pHeader,
@@ -522,23 +559,26 @@ protected:
 
 Dstar * newId51( char    const * pHeader,
                  uint8_t const * pData,
-                 size_t          size ) {
+                 size_t          size,
+                 Radio         * pIdle ) {
   return size == 0x1FB40  &&  memcmp( pHeader, "33900001", 8 ) == 0
-         ? new Id51( pHeader, pData, size ) : 0;
+         ? reuse< Id51 >( pIdle, pHeader, pData, size ) : 0;
 }
 
 Dstar * newId51p( char    const * pHeader,
                   uint8_t const * pData,
-                  size_t          size ) {
+                  size_t          size,
+                  Radio         * pIdle ) {
   return size == 0x1FB40  &&  memcmp( pHeader, "33900002", 8 ) == 0
-         ? new Id51p( pHeader, pData, size ) : 0;
+         ? reuse< Id51p >( pIdle, pHeader, pData, size ) : 0;
 }
 
 Dstar * newId51p2( char    const * pHeader,
                    uint8_t const * pData,
-                   size_t          size ) {
+                   size_t          size,
+                   Radio         * pIdle ) {
   return size == 0x1FB40  &&  memcmp( pHeader, "33900003", 8 ) == 0
-         ? new Id51p2( pHeader, pData, size ) : 0;
+         ? reuse< Id51p2 >( pIdle, pHeader, pData, size ) : 0;
 }
 
 // ==============================================================================
@@ -604,6 +644,18 @@ class Id5100 : public IdDr {
   virtual size_t               getCount(       void                         ) const {
     return Id5100Memory::CHANNELS;
   }
+  virtual ImageRegion const  * getRegions(     size_t * count               ) const {
+    static ImageRegion const regions[] = { REGION( channel ), REGION( call ), REGION( fill1 ),
+                                           REGION( ignoreChannel ), REGION( skipChannel ),
+                                           REGION( skippChannel ), REGION( fill2 ), REGION( bankMap ),
+                                           REGION( fill3 ), REGION( comment ), REGION( bankName ),
+                                           REGION( fill4 ), REGION( scanEdge ), REGION( fill5 ),
+                                           REGION( dstarRepeater ), REGION( groupName ), REGION( myCall ),
+                                           REGION( urCall ), REGION( urCallName ), REGION( fill9 ),
+                                           REGION( ident ) };
+    *count = COUNT_OF( regions );
+    return regions;
+  }
 
   virtual bool                 getIgnore(      size_t   index               ) const {
     return getBit( pMemory->ignoreChannel, index );
@@ -656,6 +708,10 @@ class Id5100 : public IdDr {
     pMemory->bankMap[ index ].index = value;
     return true;
   }
+  virtual bool                 swapChannels(   size_t   a,     size_t b     )       {
+    swapBytes( & pMemory->bankMap[ a ], & pMemory->bankMap[ b ], sizeof pMemory->bankMap[ 0 ] );
+    return IdDr::swapChannels( a, b );
+  }
 
  public:
   Id5100( char    const * pHeader,
@@ -669,7 +725,8 @@ class Id5100 : public IdDr {
 
 Dstar * newId5100( char    const * pHeader,
                    uint8_t const * pData,
-                   size_t          size ) {
+                   size_t          size,
+                   Radio         * pIdle ) {
   return size == 0x2A380  &&  memcmp( pHeader, "34840001", 8 ) == 0
-         ? new Id5100( pHeader, pData, size ) : 0;
+         ? reuse< Id5100 >( pIdle, pHeader, pData, size ) : 0;
 }
@@ -0,0 +1,218 @@
+//==================================================================================================
+//  Json.cpp is the NDJSON export class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#include "Json.hpp"
+#include "Stats.hpp"
+
+class JsonLine {              // a JSON text, written to the Output whenever the buffer fills
+  Output & output;
+  size_t   used,
+           bytes;         // total written
+  char     buffer[ 4096 ];
+  JsonLine(             void                 );  // Intentionally not implemented
+  JsonLine(             JsonLine const & rhs );  // Intentionally not implemented
+  JsonLine & operator=( JsonLine const & rhs );  // Intentionally not implemented
+ public:
+  JsonLine( Output & output ) : output( output ), used( 0 ), bytes( 0 ) {}
+  ~JsonLine( void ) {
+    flush();
+  }
+  void   flush( void ) {
+    if ( used > 0 ) {
+      output.write( buffer, used );
+      bytes += used;
+      used   = 0;
+    }
+  }
+  void   put( char c ) {
+    if ( used == sizeof buffer ) {
+      flush();
+    }
+    buffer[ used++ ] = c;
+  }
+  void   put( char const * pText ) {
+    for (  ;  *pText != 0;  put( *pText++ ) );
+  }
+  void   putEscaped( char const * pText ) {   // the inside of a JSON string
+    for (  ;  *pText != 0;  pText++ ) {
+      unsigned char c = *pText;
+      if ( c < ' '  ||  c > '~' ) {
+        put( "\\u00" );
+        put( "0123456789abcdef"[ c >> 4 ] );
+        put( "0123456789abcdef"[ c & 0xF ] );
+      } else {
+        if ( c == '"'  ||  c == '\\' ) {
+          put( '\\' );
+        }
+        put( (char)c );
+      }
+    }
+  }
+  size_t getBytes( void ) const {
+    return bytes + used;
+  }
+};
+
+// Splits a number, with an optional unit, into sign, digits before & after
+// the point, and the power of ten that makes it Hz.  False if not a number.
+static bool splitNumber( char const *  pValue,
+                         bool        & isNegative,
+                         char const *& pWhole,   size_t & whole,
+                         char const *& pFraction, size_t & fraction,
+                         size_t      & scale ) {
+  isNegative = *pValue == '-';
+  pWhole     = pValue + isNegative;
+  for ( whole = 0;  isdigit( pWhole[ whole ] );  whole++ );
+  pFraction  = pWhole + whole;
+  fraction   = 0;
+  if ( *pFraction == '.' ) {
+    for ( pFraction++;  isdigit( pFraction[ fraction ] );  fraction++ );
+    if ( fraction == 0 ) {
+      return false;
+    }
+  }
+  char const * pUnit = pFraction + fraction;
+  if ( whole == 0 ) {
+    return false;
+  } else if ( strcmp( pUnit, "kHz" ) == 0 ) {
+    scale = 3;
+  } else if ( strcmp( pUnit, "Hz"  ) == 0 ) {
+    scale = 0;
+  } else if ( *pUnit != 0 ) {
+    return false;
+  } else {
+    scale = fraction == 6 ? 6 : 0;    // the CSV's MHz frequencies
+  }
+  return true;
+}
+
+size_t Json::number( char const * pValue,
+                     char       * pText ) {
+  bool         isNegative;
+  char const * pWhole,
+             * pFraction;
+  size_t       whole,
+               fraction,
+               scale,
+               length = 0;
+  char         digits[ NUMBER_SIZE - 3 ];
+  if ( !splitNumber( pValue, isNegative, pWhole, whole, pFraction, fraction, scale )
+      ||  whole + fraction + scale >= sizeof digits ) {
+    strcpy( pText, "null" );                  // not a number:  unknown, rather than a false 0
+    return 4;
+  }
+  size_t count = 0;                           // the digits, with the point moved "scale" places right
+  memcpy( & digits[ count ], pWhole, whole );
+  count += whole;
+  for ( size_t index = 0;  index < scale;  index++ ) {
+    digits[ count++ ] = index < fraction ? pFraction[ index ] : '0';
+  }
+  size_t point = count;
+  for ( size_t index = scale;  index < fraction;  index++ ) {
+    digits[ count++ ] = pFraction[ index ];
+  }
+  for (  ;  count > point  &&  digits[ count - 1 ] == '0';  count-- );   // trailing fraction zeros
+  size_t first = 0;
+  for (  ;  first + 1 < point  &&  digits[ first ] == '0';  first++ );  // leading zeros
+  if ( isNegative ) {
+    pText[ length++ ] = '-';
+  }
+  for ( size_t index = first;  index < count;  index++ ) {
+    if ( index == point ) {
+      pText[ length++ ] = '.';
+    }
+    pText[ length++ ] = digits[ index ];
+  }
+  pText[ length ] = 0;
+  return length;
+}
+
+void Json::dump( Radio    const * pRadio,
+                 Output         & output,
+                 uint8_t  const * pSelect,
+                 CsvField const * pPlan ) {
+  Stats::Span span( Stats::DUMP );
+  CsvField const * const csvField = pPlan ? pPlan : pRadio->csvHeader();
+  unsigned char kinds[ 256 ];
+  size_t csvFieldCount = 0;
+  for (  ;  csvField[ csvFieldCount ].fieldName != 0  &&  csvFieldCount < sizeof kinds;  csvFieldCount++ ) {
+    size_t width;         // typed by the model, so every selection of channels gets the same types
+    switch ( csvFieldCount ? pRadio->getFieldType( csvField[ csvFieldCount ].getField, & width ) : CsvField::WHOLE ) {
+      case CsvField::ON_OFF:   kinds[ csvFieldCount ] = BOOLEAN;  break;
+      case CsvField::WHOLE:
+      case CsvField::DECIMAL:  kinds[ csvFieldCount ] = NUMBER;   break;
+      default:                 kinds[ csvFieldCount ] = STRING;   break;
+    }
+  }
+  size_t offset = pRadio->getOffset();
+  char   work[ 1024 ];
+
+  JsonLine line( output );
+  size_t count  = 0,
+         errors = 0;
+  for ( size_t lineIndex = 0;  lineIndex < pRadio->getCount();  lineIndex++ ) {
+    if ( (pSelect != 0  &&  !pSelect[ lineIndex ])  ||  !(pRadio->*csvField[ 0 ].getField)( lineIndex, 0 ) ) {
+      continue;
+    }
+    sprintf( work, "%d", (int)(lineIndex + offset) );
+    for ( size_t fieldIndex = 0;  fieldIndex < csvFieldCount;  fieldIndex++ ) {
+      if ( fieldIndex > 0  &&  !(pRadio->*csvField[ fieldIndex ].getField)( lineIndex, work ) ) {
+        diagnose( Diagnostic::UNKNOWN_FIELD_VALUE, (int)(lineIndex + offset), csvField[ fieldIndex ].fieldName,
+                  "Channel %d, field '%s': Unknown field value '%s'",
+                  (int)(lineIndex + offset), csvField[ fieldIndex ].fieldName, work );
+        errors++;
+      }
+      line.put( fieldIndex ? ",\"" : "{\"" );
+      line.putEscaped( csvField[ fieldIndex ].fieldName );
+      line.put( "\":" );
+      if ( kinds[ fieldIndex ] & BOOLEAN ) {
+        line.put( stricmp( work, "On" ) == 0 ? "true" : "false" );
+      } else if ( kinds[ fieldIndex ] & NUMBER ) {
+        char text[ NUMBER_SIZE ];
+        number( work, text );
+        line.put( text );
+      } else {
+        size_t length = strlen( work );
+        bool   isQuoted = length >= 2  &&  work[ 0 ] == '"'  &&  work[ length - 1 ] == '"';
+        line.put( '"' );
+        if ( isQuoted ) {                     // escape() output:  already escaped, except control & 8-bit bytes
+          work[ length - 1 ] = 0;
+          for ( char const * pText = work + 1;  *pText != 0;  pText++ ) {
+            if ( *pText == '\\'  &&  pText[ 1 ] != 0 ) {
+              line.put( *pText++ );
+              line.put( *pText );
+            } else {
+              char single[ 2 ] = { *pText, 0 };
+              line.putEscaped( single );
+            }
+          }
+        } else {
+          line.putEscaped( work );
+        }
+        line.put( '"' );
+      }
+    }
+    line.put( "}\n" );
+    count++;
+  }
+  line.flush();
+  Stats::add( Stats::BYTES_OUT,    line.getBytes() );
+  Stats::add( Stats::CHANNELS,     count  );
+  Stats::add( Stats::FIELDS,       count * (csvFieldCount - 1) );
+  Stats::add( Stats::PARSE_ERRORS, errors );
+}
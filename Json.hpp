@@ -0,0 +1,57 @@
+//==================================================================================================
+//  Json.hpp is the NDJSON export class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Exports the channels as NDJSON:  one object per channel and line, keyed by
+//  the CSV header field names, with the CSV field text typed by column as the
+//  model types the field (Radio::getFieldType), whatever the channels hold:  an
+//  On/Off field is boolean;  a numeric field is a number, in Hz where the CSV
+//  has units:  "kHz" and "Hz" suffixes, and six-decimal MHz frequencies, become
+//  Hz (null if the text is not a number).  Other fields are strings;  names &
+//  calls keep their CSV escaping, which is JSON's, plus \u escapes for control
+//  characters and non-ASCII bytes (as Latin-1).  Each line is built in a fixed
+//  buffer:  no heap allocation.
+
+#ifndef JSON_HPP
+#define JSON_HPP
+
+#include "Radio.hpp"
+
+class Json {
+  Json(             void             );  // Intentionally not implemented
+  Json(             Json const & rhs );  // Intentionally not implemented
+  Json & operator=( Json const & rhs );  // Intentionally not implemented
+
+ public:
+  enum Kind {             // of a column
+    BOOLEAN = 1,
+    NUMBER  = 2,
+    STRING  = 0
+  };
+
+  enum {
+    NUMBER_SIZE = 80      // for number()
+  };
+
+  static void     dump(   Radio const * pRadio, Output & output, uint8_t const * pSelect = 0,
+                          CsvField const * pPlan = 0 );   // see Radio::dump
+
+  // CSV number text as JSON, also used by other exports
+  static size_t   number( char const  * pValue, char * pText );   // as JSON (in Hz, or null);  returns the length
+};
+
+#endif
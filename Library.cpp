@@ -0,0 +1,177 @@
+//==================================================================================================
+//  Library.cpp is the embeddable in-memory interface class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#include "Library.hpp"
+#include "Arrow.hpp"
+#include "Json.hpp"
+#include "Stats.hpp"
+
+class Scope {             // routes status & diagnostics for one call
+  diagnose_t * const pSavedDiagnose;
+  void       * const pSavedContext;
+  Scope(             void              );  // Intentionally not implemented
+  Scope(             Scope const & rhs );  // Intentionally not implemented
+  Scope & operator=( Scope const & rhs );  // Intentionally not implemented
+
+  static void collect( void * pContext, Diagnostic const * pDiagnostic ) {
+    Library::Result * pResult = (Library::Result *)pContext;
+    if ( pResult == 0 ) {
+      return;
+    }
+    if ( pResult->count < Library::DIAGNOSTICS ) {
+      pResult->diagnostics[ pResult->count ] = *pDiagnostic;
+    }
+    pResult->count++;
+  }
+
+ public:
+  Scope( Library::Result * pResult, bool isFirst = true )   // later slices of a Task add to its Result
+      : pSavedDiagnose( pDiagnose ), pSavedContext( pDiagnoseContext ) {
+    quietDepth++;
+    pDiagnose        = collect;
+    pDiagnoseContext = pResult;
+    if ( pResult != 0  &&  isFirst ) {
+      pResult->count = 0;
+    }
+  }
+  ~Scope( void ) {
+    quietDepth--;
+    pDiagnose        = pSavedDiagnose;
+    pDiagnoseContext = pSavedContext;
+  }
+};
+
+Radio * Library::create( void const * pImage,
+                         size_t       size,
+                         bool         isBinary,
+                         Result     * pResult,
+                         Pool       * pPool ) {
+  Scope       scope( pResult );
+  MemoryInput input( pImage, size );
+  return pPool ? pPool->create( input, isBinary ) : Radio::create( input, isBinary );
+}
+
+bool Library::exportCsv( Radio const * pRadio,
+                         Output      & csv,
+                         Result      * pResult ) {
+  Scope scope( pResult );
+  pRadio->dump( csv );
+  return true;
+}
+
+bool Library::exportJson( Radio const * pRadio,
+                          Output      & ndjson,
+                          Result      * pResult ) {
+  Scope scope( pResult );
+  Json::dump( pRadio, ndjson );
+  return true;
+}
+
+bool Library::exportArrow( Radio const * pRadio,
+                           Output      & arrow,
+                           Result      * pResult ) {
+  Scope scope( pResult );
+  return Arrow::dump( pRadio, arrow );
+}
+
+bool Library::importCsv( Radio      * pRadio,
+                         char const * pCsv,
+                         size_t       size,
+                         Result     * pResult ) {
+  Scope       scope( pResult );
+  MemoryInput input( pCsv, size );
+  return pRadio->load( input );
+}
+
+bool Library::save( Radio      * pRadio,
+                    Output     & image,
+                    bool         isBinary,
+                    char const * pComment,
+                    Result     * pResult ) {
+  Scope scope( pResult );
+  pRadio->save( image, isBinary, pComment );
+  return true;
+}
+
+void Library::Task::start( void ) {
+  result.count = 0;
+  progress     = Radio::MORE;
+  executor.post( this );
+}
+
+void Library::Task::run( void ) {
+  {
+    Scope scope( & result, false );
+    progress = step( Stats::now() + budget );
+  }
+  if ( progress == Radio::MORE ) {
+    executor.post( this );
+  } else if ( pDone != 0 ) {
+    pDone( pContext, this );    // last:  it may delete this
+  }
+}
+
+Library::CreateTask::CreateTask( Executor   & executor,
+                                 uint64_t     budget,
+                                 done_t     * pDone,
+                                 void       * pContext,
+                                 void const * pImage,
+                                 size_t       size,
+                                 bool         isBinary,
+                                 Pool       * pPool )
+    : Task( executor, budget, pDone, pContext ), input( pImage, size ), local( 0 ), pPool( pPool ),
+      decoder( input, isBinary, pPool ? pPool->getScratch() : local ), pRadio( 0 ), isBinary( isBinary ) {}
+
+Radio::Progress Library::CreateTask::step( uint64_t deadline ) {
+  Radio::Progress progress;
+  while ( (progress = decoder.step( SLICE )) == Radio::MORE ) {
+    if ( Stats::now() >= deadline ) {
+      return progress;
+    }
+  }
+  if ( progress == Radio::DONE ) {      // detection is quick;  it finishes this slice
+    pRadio = pPool ? pPool->create(  decoder.getHeader(), decoder.getData(), decoder.getSize(), isBinary )
+                   : Radio::create( decoder.getHeader(), decoder.getData(), decoder.getSize(), isBinary );
+  }
+  return pRadio ? Radio::DONE : Radio::FAILED;
+}
+
+Radio::Progress Library::ExportTask::step( uint64_t deadline ) {
+  Radio::Progress progress;
+  while ( (progress = pRadio->dump( csv, next, SLICE )) == Radio::MORE ) {
+    if ( Stats::now() >= deadline ) {
+      break;
+    }
+  }
+  return progress;
+}
+
+Radio::Progress Library::ImportTask::step( uint64_t deadline ) {
+  Radio::Progress progress;
+  while ( (progress = pRadio->load( input, loading, SLICE )) == Radio::MORE ) {
+    if ( Stats::now() >= deadline ) {
+      break;
+    }
+  }
+  return progress;
+}
+
+Radio::Progress Library::SaveTask::step( uint64_t deadline ) {
+  pRadio->save( image, isBinary, pComment );
+  return Radio::DONE;
+}
@@ -0,0 +1,161 @@
+//==================================================================================================
+//  Library.hpp is the embeddable in-memory interface class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  The converter without files or a console:  images and CSV text are passed
+//  as buffers (or, for output, any Output, such as a MemoryOutput or a
+//  CallbackOutput), progress lines are suppressed, and the errors that the
+//  command line prints as "*** ... ***" are returned in a Result instead.
+//  Link with libRadio2csv ("make lib"), which has no main().
+//
+//  For an event loop that must not block, each call also has a Task form,
+//  run by the caller's Executor in slices:  a slice stops soon after "budget"
+//  nanoseconds (ICF decode and CSV load & dump check the clock every SLICE
+//  lines or channels), then posts the rest as a new slice.  When the Task is
+//  done, it calls back;  the callback may delete the Task.  Slices of one Task
+//  never overlap, but may run on any thread.
+
+#ifndef LIBRARY_HPP
+#define LIBRARY_HPP
+
+#include "Radio.hpp"
+
+class Library {
+  Library(             void                );  // Intentionally not implemented
+  Library(             Library const & rhs );  // Intentionally not implemented
+  Library & operator=( Library const & rhs );  // Intentionally not implemented
+
+ public:
+  enum {
+    DIAGNOSTICS = 16,     // kept per call;  later ones are only counted
+    SLICE       = 16      // lines or channels between checks of the clock
+  };
+  struct Result {
+    size_t     count;     // Diagnostics reported by the call
+    Diagnostic diagnostics[ DIAGNOSTICS ];
+  };
+
+  // Each returns false (or 0) on failure;  pResult may be 0.  With a Pool,
+  // create() reuses its idle Radio of the same model;  give it back with
+  // pPool->release() instead of delete.
+  static Radio * create(    void  const * pImage, size_t       size,     bool   isBinary, Result * pResult,
+                            Pool        * pPool = 0 );
+  static bool    exportCsv( Radio const * pRadio, Output     & csv,                         Result * pResult );
+  static bool    exportJson(Radio const * pRadio, Output     & ndjson,                      Result * pResult );
+  static bool    exportArrow(Radio const * pRadio, Output    & arrow,                       Result * pResult );
+  static bool    importCsv( Radio       * pRadio, char const * pCsv,     size_t size,       Result * pResult );
+  static bool    save(      Radio       * pRadio, Output     & image,    bool   isBinary,
+                            char  const * pComment,                                         Result * pResult );
+
+  class Task;
+  class Executor {
+   public:
+    virtual      ~Executor( void         ) {}
+    virtual void  post(     Task * pTask ) = 0;  // call pTask->run() later, from the event loop
+  };
+
+  class Task {
+    Task(             void           );  // Intentionally not implemented
+    Task(             Task const & rhs );  // Intentionally not implemented
+    Task & operator=( Task const & rhs );  // Intentionally not implemented
+   public:
+    typedef void done_t( void * pContext, Task * pTask );
+
+    virtual         ~Task(      void ) {}
+    void             start(     void );   // posts the first slice
+    void             run(       void );   // one slice;  then posts the next, or calls back
+    bool             isOk(      void ) const {
+      return progress == Radio::DONE;
+    }
+    Result const   & getResult( void ) const {
+      return result;
+    }
+
+   protected:
+    Task( Executor & executor, uint64_t budget, done_t * pDone, void * pContext )
+        : executor( executor ), budget( budget ), pDone( pDone ), pContext( pContext ), progress( Radio::MORE ) {}
+    virtual Radio::Progress step( uint64_t deadline ) = 0;   // until done, or past the deadline
+
+   private:
+    Executor        & executor;
+    uint64_t  const   budget;
+    done_t          * pDone;
+    void            * pContext;
+    Result            result;
+    Radio::Progress   progress;
+    uint8_t           fill[ 4 ];
+  };
+
+  class CreateTask : public Task {      // create();  then getRadio()
+    MemoryInput   input;
+    Arena         local;
+    Pool        * pPool;
+    Decoder       decoder;
+    Radio       * pRadio;
+    bool const    isBinary;
+    uint8_t       fill[ 7 ];
+   protected:
+    virtual Radio::Progress step( uint64_t deadline );
+   public:
+    CreateTask( Executor & executor, uint64_t budget, done_t * pDone, void * pContext,
+                void const * pImage, size_t size, bool isBinary, Pool * pPool = 0 );
+    Radio * getRadio( void ) const {      // the caller's, once done
+      return pRadio;
+    }
+  };
+
+  class ExportTask : public Task {      // exportCsv()
+    Radio const * pRadio;
+    Output      & csv;
+    size_t        next;
+   protected:
+    virtual Radio::Progress step( uint64_t deadline );
+   public:
+    ExportTask( Executor & executor, uint64_t budget, done_t * pDone, void * pContext,
+                Radio const * pRadio, Output & csv )
+        : Task( executor, budget, pDone, pContext ), pRadio( pRadio ), csv( csv ), next( 0 ) {}
+  };
+
+  class ImportTask : public Task {      // importCsv()
+    Radio          * pRadio;
+    MemoryInput      input;
+    Radio::Loading   loading;
+   protected:
+    virtual Radio::Progress step( uint64_t deadline );
+   public:
+    ImportTask( Executor & executor, uint64_t budget, done_t * pDone, void * pContext,
+                Radio * pRadio, char const * pCsv, size_t size )
+        : Task( executor, budget, pDone, pContext ), pRadio( pRadio ), input( pCsv, size ) {}
+  };
+
+  class SaveTask : public Task {        // save(), in one slice
+    Radio        * pRadio;
+    Output       & image;
+    char  const  * pComment;
+    bool   const   isBinary;
+    uint8_t        fill[ 7 ];
+   protected:
+    virtual Radio::Progress step( uint64_t deadline );
+   public:
+    SaveTask( Executor & executor, uint64_t budget, done_t * pDone, void * pContext,
+              Radio * pRadio, Output & image, bool isBinary, char const * pComment )
+        : Task( executor, budget, pDone, pContext ), pRadio( pRadio ), image( image ), pComment( pComment ),
+          isBinary( isBinary ) {}
+  };
+};
+
+#endif
@@ -0,0 +1,207 @@
+//==================================================================================================
+//  Merge.cpp is the image merge class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#include "Merge.hpp"
+#include "Stats.hpp"
+
+static bool isCsvName( char const * pName ) {
+  size_t length = strlen( pName );
+  return length > 4  &&  stricmp( & pName[ length - 4 ], ".csv" ) == 0;
+}
+
+Radio * Merge::open( char const  * pName,
+                     Radio const * pFirst,
+                     bool          isBinary ) {
+  FILE * pFile = fopen( pName, "rb" );
+  if ( pFile == 0 ) {
+    fprintf( stderr, "*** File not found: '%s' ***\n", pName );
+    return 0;
+  }
+  Stats::setFile( pName );
+  Radio * pRadio = 0;
+  if ( !isCsvName( pName ) ) {
+    pRadio = Radio::create( pFile, isBinaryName( pName ) );
+  } else if ( pFirst == 0 ) {
+    fprintf( stderr, "*** The first source must be a radio file, not '%s' ***\n", pName );
+  } else {
+    pRadio = Radio::create( pFirst->pHeader, pFirst->pData, pFirst->size, isBinary );
+    for ( size_t index = 0;  pRadio != 0  &&  index < pRadio->getCount();  index++ ) {
+      if ( pRadio->getValid( index ) ) {
+        pRadio->setValid( index, false );
+      }
+    }
+    FileInput input( pFile );
+    if ( pRadio != 0  &&  !pRadio->load( input ) ) {
+      fprintf( stderr, "*** Unable to load file '%s' ***\n", pName );
+      delete pRadio;
+      pRadio = 0;
+    }
+  }
+  fclose( pFile );
+  if ( pRadio != 0  &&  pFirst != 0  &&  (pRadio->model != pFirst->model  ||  pRadio->getCount() != pFirst->getCount()) ) {
+    fprintf( stderr, "*** '%s' is not the same model as the first source ***\n", pName );
+    delete pRadio;
+    pRadio = 0;
+  }
+  return pRadio;
+}
+
+void Merge::copy( Radio       * pTarget,
+                  size_t        to,
+                  Radio const * pSource,
+                  size_t        from ) {
+  CsvField const * const csvField = pTarget->csvHeader();   // the source's too:  the same model
+  pTarget->setValid( to, true );
+  for ( size_t fieldIndex = 1;  csvField[ fieldIndex ].fieldName != 0;  fieldIndex++ ) {
+    char work[ 1024 ];
+    if ( (pSource->*csvField[ fieldIndex ].getField)( from, work ) ) {
+      char * pNext = work;
+      (pTarget->*csvField[ fieldIndex ].setField)( to, parse( & pNext ) );
+    }
+  }
+}
+
+void Merge::keyOf( Radio const * pRadio,
+                   size_t        index,
+                   uint32_t      present,
+                   uint32_t    * pKey ) {
+  static ChannelFrame::Column const columns[ KEYS ]
+      = { ChannelFrame::RX_HZ,            ChannelFrame::MODULATION,       ChannelFrame::FM_SQUELCH,
+          ChannelFrame::CTCSS_ENCODE_DHZ, ChannelFrame::CTCSS_DECODE_DHZ, ChannelFrame::DCS_CODE };
+  for ( size_t which = 0;  which < KEYS;  which++ ) {
+    pKey[ which ] = (present & 1 << columns[ which ]) != 0 ? ChannelFrame::getCell( pRadio, index, columns[ which ], 0 )
+                                                           : (uint32_t)ChannelFrame::UNKNOWN;
+  }
+}
+
+size_t Merge::find( Index    const & index,
+                    uint32_t const * pKey ) {
+  uint32_t hash = 2166136261U;                  // FNV-1a a word at a time,
+  for ( size_t which = 0;  which < KEYS;  which++ ) {
+    hash = (hash ^ pKey[ which ]) * 16777619U;
+  }
+  hash ^= hash >> 16;                           // then mixed down into the low bits
+  hash *= 0x85EBCA6BU;
+  hash ^= hash >> 13;
+  size_t slot = hash & (index.slotCount - 1);
+  while ( index.pSlots[ slot ] != 0
+      &&  memcmp( & index.pKeys[ (index.pSlots[ slot ] - 1) * KEYS ], pKey, KEYS * sizeof pKey[ 0 ] ) != 0 ) {
+    slot = (slot + 1) & (index.slotCount - 1);
+  }
+  return slot;
+}
+
+Radio * Merge::run( size_t               count,
+                    char const * const * ppNames,
+                    unsigned             policy ) {
+  Stats::Span span( Stats::LOAD );
+  bool    isBinary = count > 0  &&  isBinaryName( ppNames[ 0 ] );
+  Radio * pFirst   = count > 0 ? open( ppNames[ 0 ], 0, isBinary ) : 0;
+  Radio * pMerged  = pFirst ? Radio::create( pFirst->pHeader, pFirst->pData, pFirst->size, isBinary ) : 0;
+  if ( pMerged == 0 ) {
+    delete pFirst;
+    return 0;
+  }
+  size_t   const channels = pMerged->getCount();
+  uint32_t const present  = ChannelFrame::columnsOf( pMerged, 0, 0 );
+  for ( size_t to = 0;  to < channels;  to++ ) {
+    if ( pMerged->getValid( to ) ) {
+      pMerged->setValid( to, false );
+    }
+  }
+  Index    index;
+  index.slotCount = 64;
+  while ( index.slotCount < channels * 2 ) {    // at most half full
+    index.slotCount *= 2;
+  }
+  index.pSlots = (uint32_t *)calloc( index.slotCount, sizeof index.pSlots[ 0 ] );
+  index.pKeys  = (uint32_t *)malloc( channels * KEYS * sizeof index.pKeys[ 0 ] );
+  size_t * pPending = (size_t *)malloc( channels * sizeof (size_t) );
+  size_t   nextFree = 0,                        // no lower channel index is free
+           total    = 0;
+
+  for ( size_t source = 0;  source < count;  source++ ) {
+    Radio * pSource = source == 0 ? pFirst : open( ppNames[ source ], pFirst, isBinary );
+    if ( pSource == 0 ) {
+      delete pMerged;
+      pMerged = 0;
+      break;
+    }
+    size_t merged     = 0,
+           moved      = 0,
+           duplicates = 0,
+           dropped    = 0,
+           pending    = 0;
+    for ( int pass = 0;  pass < 2;  pass++ ) {  // its own numbers first;  then the ones taken
+      size_t const last = pass == 0 ? channels : pending;
+      for ( size_t which = 0;  which < last;  which++ ) {
+        size_t   from = pass == 0 ? which : pPending[ which ];
+        size_t   to   = from;
+        size_t   slot = 0;
+        uint32_t key[ KEYS ];
+        if ( pass == 0  &&  !pSource->getValid( from ) ) {
+          continue;
+        }
+        if ( (policy & DEDUPE) != 0 ) {
+          keyOf( pSource, from, present, key );
+          slot = find( index, key );
+          if ( index.pSlots[ slot ] != 0 ) {
+            duplicates++;
+            continue;
+          }
+        }
+        if ( pMerged->getValid( to ) ) {
+          if ( pass == 0 ) {
+            pPending[ pending++ ] = from;
+            continue;
+          }
+          while ( nextFree < channels  &&  pMerged->getValid( nextFree ) ) {
+            nextFree++;
+          }
+          if ( (policy & RELOCATE) == 0  ||  nextFree == channels ) {
+            dropped++;
+            continue;
+          }
+          to = nextFree;
+          moved++;
+        }
+        copy( pMerged, to, pSource, from );
+        merged++;
+        if ( (policy & DEDUPE) != 0 ) {
+          memcpy( & index.pKeys[ to * KEYS ], key, sizeof key );
+          index.pSlots[ slot ] = (uint32_t)(to + 1);
+        }
+      }
+    }
+    status( "--- %s:  %d channels merged (%d moved), %d duplicates, %d dropped ---\n",
+            ppNames[ source ], (int)merged, (int)moved, (int)duplicates, (int)dropped );
+    total += merged;
+    if ( pSource != pFirst ) {
+      delete pSource;
+    }
+  }
+  free( pPending );
+  free( index.pKeys );
+  free( index.pSlots );
+  delete pFirst;
+  if ( pMerged != 0 ) {
+    status( "--- Channels merged: %d ---\n", (int)total );
+    Stats::add( Stats::CHANNELS, total );
+  }
+  return pMerged;
+}
@@ -0,0 +1,67 @@
+//==================================================================================================
+//  Merge.hpp is the image merge class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  "--merge" combines the channels of several sources of one model into one
+//  image:  radio files, or CSV files (loaded into an empty copy of the first
+//  source, which must be a radio file, and which supplies everything but the
+//  channels).  Sources go in priority order, and a channel keeps its number
+//  unless that is taken by an earlier source;  then, by policy, it is dropped
+//  (the default), or RELOCATEd to the lowest free channel number.  With DEDUPE,
+//  a channel with the receive frequency, mode, squelch, tones & DCS code of one
+//  already merged is dropped;  a hash index of those keys, one entry per merged
+//  channel, finds a duplicate without comparing pairs.  Each channel copies
+//  field by field through the model's CSV getters & setters, so every field
+//  (not just the typed ones) survives.  Each source reports its counts.
+
+#ifndef MERGE_HPP
+#define MERGE_HPP
+
+#include "ChannelFrame.hpp"
+
+class Merge {
+  Merge(             void              );  // Intentionally not implemented
+  Merge(             Merge const & rhs );  // Intentionally not implemented
+  Merge & operator=( Merge const & rhs );  // Intentionally not implemented
+
+ public:
+  enum {                  // policy bits
+    RELOCATE = 1,
+    DEDUPE   = 2
+  };
+
+  // The merged image, as a new Radio of the first source's model;  0 (with a
+  // message) if a source is not found, is invalid, or is another model.
+  static Radio * run( size_t count, char const * const * ppNames, unsigned policy );
+
+ private:
+  enum {
+    KEYS = 6              // values in a DEDUPE key
+  };
+  struct Index {          // open-addressed:  (merged channel index + 1) per slot
+    uint32_t * pSlots;
+    uint32_t * pKeys;     // KEYS per channel index
+    size_t     slotCount;
+  };
+
+  static Radio * open(    char const * pName, Radio const * pFirst, bool isBinary );  // isBinary:  the first's
+  static void    copy(    Radio * pTarget, size_t to, Radio const * pSource, size_t from );
+  static void    keyOf(   Radio const * pRadio, size_t index, uint32_t present, uint32_t * pKey );
+  static size_t  find(    Index const & index, uint32_t const * pKey );   // its slot, used or not
+};
+
+#endif
@@ -0,0 +1,117 @@
+//==================================================================================================
+//  Queue.cpp is the bounded lock-free queue class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#include "Queue.hpp"
+
+#include <stddef.h>
+
+#ifdef  _WIN32
+# include <windows.h>
+#else
+# include <sched.h>
+# include <time.h>
+#endif
+
+static void backoff( size_t & tries ) {   // waits a little longer each try
+  if ( ++tries < 64 ) {
+    return;                               // spin
+  }
+#ifdef  _WIN32
+  Sleep( tries < 128 ? 0 : 1 );
+#else
+  if ( tries < 128 ) {
+    sched_yield();
+  } else {
+    struct timespec pause = { 0, 50000 };
+    nanosleep( & pause, 0 );
+  }
+#endif
+}
+
+Queue::Queue( size_t capacity ) : mask( 1 ), head( 0 ), tail( 0 ) {
+  while ( mask < capacity ) {
+    mask <<= 1;
+  }
+  pCells = new Cell[ mask-- ];
+  for ( size_t index = 0;  index <= mask;  index++ ) {
+    pCells[ index ].sequence = index;
+    pCells[ index ].pItem    = 0;
+  }
+}
+
+Queue::~Queue( void ) {
+  delete[] pCells;
+}
+
+bool Queue::tryPush( void * pItem ) {
+  size_t position = ATOMIC_LOAD( head );
+  for ( ;; ) {
+    Cell   & cell     = pCells[ position & mask ];
+    size_t   sequence = ATOMIC_LOAD( cell.sequence );
+    if ( sequence == position ) {         // free for this position;  claim it
+      if ( ATOMIC_CAS( head, position, position + 1 ) ) {
+        cell.pItem = pItem;
+        ATOMIC_STORE( cell.sequence, position + 1 );
+        return true;
+      }
+    } else if ( (ptrdiff_t)(sequence - position) < 0 ) {
+      return false;                       // still holds the item from a lap ago
+    } else {
+      position = ATOMIC_LOAD( head );
+    }
+  }
+}
+
+void * Queue::tryPop( void ) {
+  size_t position = ATOMIC_LOAD( tail );
+  for ( ;; ) {
+    Cell   & cell     = pCells[ position & mask ];
+    size_t   sequence = ATOMIC_LOAD( cell.sequence );
+    if ( sequence == position + 1 ) {     // filled for this position;  claim it
+      if ( ATOMIC_CAS( tail, position, position + 1 ) ) {
+        void * pItem = cell.pItem;
+        ATOMIC_STORE( cell.sequence, position + mask + 1 );
+        return pItem;
+      }
+    } else if ( (ptrdiff_t)(sequence - (position + 1)) < 0 ) {
+      return 0;                           // not yet filled
+    } else {
+      position = ATOMIC_LOAD( tail );
+    }
+  }
+}
+
+void Queue::push( void * pItem ) {
+  for ( size_t tries = 0;  !tryPush( pItem );  ) {
+    backoff( tries );
+  }
+}
+
+void * Queue::pop( void ) {
+  void * pItem;
+  for ( size_t tries = 0;  (pItem = tryPop()) == 0;  ) {
+    backoff( tries );
+  }
+  return pItem;
+}
+
+size_t Queue::depth( void ) const {
+  size_t pushed = ATOMIC_LOAD( head ),
+         popped = ATOMIC_LOAD( tail );
+  return pushed > popped ? pushed - popped : 0;
+}
@@ -0,0 +1,63 @@
+//==================================================================================================
+//  Queue.hpp is the bounded lock-free queue class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  A fixed-capacity multi-producer, multi-consumer queue of pointers, without
+//  locks:  each cell carries a sequence number that tells a producer or consumer
+//  whether the cell is its turn, and a compare-and-swap claims the turn (D. Vyukov's
+//  bounded MPMC queue).  push() & pop() wait when full or empty, spinning briefly,
+//  then yielding, then sleeping, so a stalled stage costs little CPU.  Being
+//  bounded, a queue between pipeline stages also limits the work in progress.
+
+#ifndef QUEUE_HPP
+#define QUEUE_HPP
+
+#include "Radio.hpp"
+
+class Queue {
+  Queue(             void              );  // Intentionally not implemented
+  Queue(             Queue const & rhs );  // Intentionally not implemented
+  Queue & operator=( Queue const & rhs );  // Intentionally not implemented
+
+  enum {
+    LINE = 64             // cache line;  producers & consumers update different lines
+  };
+  struct Cell {
+    size_t   sequence;
+    void   * pItem;
+  };
+
+  Cell   * pCells;
+  size_t   mask;          // capacity - 1
+  uint8_t  fill1[ LINE - sizeof (Cell *) - sizeof (size_t) ];
+  size_t   head;          // next push
+  uint8_t  fill2[ LINE - sizeof (size_t) ];
+  size_t   tail;          // next pop
+  uint8_t  fill3[ LINE - sizeof (size_t) ];
+
+ public:
+  Queue(  size_t capacity );  // rounded up to a power of two
+  ~Queue( void            );
+
+  bool   tryPush( void * pItem );  // false if full
+  void * tryPop(  void         );  // 0 if empty;  items must not be 0
+  void   push(    void * pItem );
+  void * pop(     void         );
+  size_t depth(   void         ) const;  // approximate, while others push & pop
+};
+
+#endif
@@ -17,8 +17,33 @@
 //  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include "Dstar.hpp"
+#include "Arrow.hpp"
+#include "Bench.hpp"
+#include "ChannelFrame.hpp"
+#include "Compact.hpp"
+#include "Convert.hpp"
+#include "Batch.hpp"
+#include "Dedupe.hpp"
+#include "Delta.hpp"
+#include "Filter.hpp"
+#include "Json.hpp"
+#include "Merge.hpp"
+#include "Server.hpp"
+#include "Session.hpp"
+#include "Sort.hpp"
+#include "Stats.hpp"
+#include "Store.hpp"
+
+#ifdef  _WIN32
+# include <fcntl.h>
+# include <io.h>
+#endif
 
 char         const        version[]         = "Radio2csv v0.30 copyright (c) 2007-2017 by Dean Gibson/AE7Q\n";
+FILE       *              pStatus           = stderr;
+THREAD_LOCAL diagnose_t * pDiagnose         = 0;
+THREAD_LOCAL void       * pDiagnoseContext  = 0;
+THREAD_LOCAL size_t       quietDepth        = 0;
 
 double       const Radio::ctcssCodes[  50 ] = { 67.0,  69.3,  71.9,  74.4,  77.0,  79.7,  82.5,  85.4,  88.5,  91.5,
                                                 94.8,  97.4, 100.0, 103.5, 107.2, 110.9, 114.8, 118.8, 123.0, 127.3,
@@ -50,7 +75,7 @@ Routing const Routing::cqcqcq = "CQCQCQ";
 Routing const Routing::direct = "DIRECT";
 Routing const Routing::notUse = "";
 
-typedef Radio * new_t( char const * pHeader, uint8_t const * pData, size_t address );
+typedef Radio * new_t( char const * pHeader, uint8_t const * pData, size_t address, Radio * pIdle );
 new_t   newId1,
         newId800,
         newIc91d,
@@ -194,6 +219,75 @@ void strpad( char       * pTarget,
   }
 }
 
+void putLE( uint8_t  * pBytes,
+            uint64_t   value,
+            size_t     count ) {
+
+  for ( size_t index = 0;  index < count;  index++, value >>= CHAR_BIT ) {
+    pBytes[ index ] = (uint8_t)value;
+  }
+}
+
+uint64_t getLE( uint8_t const * pBytes,
+                size_t          count ) {
+  uint64_t value = 0;
+
+  while ( count-- > 0 ) {
+    value = value << CHAR_BIT | pBytes[ count ];
+  }
+  return value;
+}
+
+bool putLE32( FILE     * pFile,
+              uint32_t   value ) {
+  uint8_t bytes[ 4 ];
+
+  putLE( bytes, value, sizeof bytes );
+  return fwrite( bytes, sizeof bytes, 1, pFile ) == 1;
+}
+
+bool getLE32( FILE     * pFile,
+              uint32_t * pValue ) {
+  uint8_t bytes[ 4 ];
+
+  if ( fread( bytes, sizeof bytes, 1, pFile ) != 1 ) {
+    return false;
+  }
+  *pValue = (uint32_t)getLE( bytes, sizeof bytes );
+  return true;
+}
+
+void status( char const * pFormat, ... ) {
+  if ( pStatus != 0  &&  quietDepth == 0 ) {
+    va_list arguments;
+    va_start( arguments, pFormat );
+    vfprintf( pStatus, pFormat, arguments );
+    va_end( arguments );
+  }
+}
+
+void diagnose( Diagnostic::Code   code,
+               int                channel,
+               char const       * pField,
+               char const       * pFormat, ... ) {
+  Diagnostic diagnostic;
+  va_list    arguments;
+
+  diagnostic.code    = code;
+  diagnostic.channel = channel;
+  strpad( diagnostic.field, sizeof diagnostic.field, pField ? pField : "", 0 );
+  diagnostic.field[ sizeof diagnostic.field - 1 ] = 0;
+  va_start( arguments, pFormat );
+  vsnprintf( diagnostic.message, sizeof diagnostic.message, pFormat, arguments );
+  va_end( arguments );
+  diagnostic.message[ sizeof diagnostic.message - 1 ] = 0;
+  if ( pDiagnose != 0 ) {
+    pDiagnose( pDiagnoseContext, & diagnostic );
+  } else {
+    fprintf( stderr, "*** %s ***\n", diagnostic.message );
+  }
+}
+
 enum {
   maxBytesPerLine = 0x10
 };
@@ -241,212 +335,1127 @@ CsvField const Dstar::csvFields[]
                              reinterpret_cast< setField_t >( & Dstar::_setBankChannel  ) },
         { 0, 0, 0 } };
 
-bool Radio::load( FILE * pFile ) {
+bool Radio::load( Input & input ) {
+  Loading loading;
+  return load( input, loading, (size_t)-1 ) == DONE;
+}
+
+Radio::Progress Radio::load( Input   & input,
+                             Loading & loading,
+                             size_t    lines ) {
+  Stats::Span span( Stats::LOAD );
 
   CsvField const * const csvField = csvHeader();
   char line[ 1024 ];
-  if ( fgets( line, sizeof line, pFile ) == 0 ) {
-    fprintf( stderr, "*** Missing CSV data ***\n" );
-    return false;
-  }
-  char * pNext = line;
-  size_t csvFieldCount = 0;
-  size_t csvOrder[ 256 ];
-  while ( *pNext != 0  &&  csvField[ csvFieldCount ].fieldName != 0  &&  csvFieldCount < COUNT_OF( csvOrder ) ) {
-    char * pTemp = parse( & pNext );
-    size_t fieldIndex = 0;
-    for (  ;  csvField[ fieldIndex ].fieldName != 0  ;  fieldIndex++ ) {
-      if ( stricmp( pTemp, csvField[ fieldIndex ].fieldName ) == 0 ) {
-        csvOrder[ csvFieldCount++ ] = fieldIndex;
-        break;
+  if ( loading.columns == 0 ) {
+    if ( input.gets( line, sizeof line ) == 0 ) {
+      diagnose( Diagnostic::MISSING_CSV_DATA, -1, 0, "Missing CSV data" );
+      return FAILED;
+    }
+    char * pNext = line;
+    while ( *pNext != 0  &&  csvField[ loading.columns ].fieldName != 0
+                         &&  loading.columns < COUNT_OF( loading.order ) ) {
+      char * pTemp = parse( & pNext );
+      size_t fieldIndex = 0;
+      for (  ;  csvField[ fieldIndex ].fieldName != 0  ;  fieldIndex++ ) {
+        if ( stricmp( pTemp, csvField[ fieldIndex ].fieldName ) == 0 ) {
+          loading.order[ loading.columns++ ] = fieldIndex;
+          break;
+        }
+      }
+      if ( loading.pPlan != 0  &&  fieldIndex > 0  &&  csvField[ fieldIndex ].fieldName != 0 ) {
+        size_t planIndex = 0;
+        while ( loading.pPlan[ planIndex ].fieldName != 0
+               &&  loading.pPlan[ planIndex ].fieldName != csvField[ fieldIndex ].fieldName ) {
+          planIndex++;
+        }
+        if ( loading.pPlan[ planIndex ].fieldName == 0 ) {
+          loading.order[ loading.columns - 1 ] = Loading::SKIPPED;
+        }
+      }
+      if ( csvField[ fieldIndex ].fieldName == 0 ) {
+        diagnose( Diagnostic::UNKNOWN_CSV_FIELD, -1, pTemp, "Unknown CSV header field name '%s'", pTemp );
+        return FAILED;
       }
     }
-    if ( csvField[ fieldIndex ].fieldName == 0 ) {
-      fprintf( stderr, "*** Unknown CSV header field name '%s' ***\n", pTemp );
-      return false;
+    if ( loading.columns == 0  ||  loading.order[ 0 ] != 0 ) {
+      char const * pName = loading.columns ? csvField[ loading.order[ 0 ] ].fieldName : "";
+      diagnose( Diagnostic::FIRST_CSV_FIELD, -1, pName,
+                "First CSV header field name '%s' is not the channel number", pName );
+      return FAILED;
     }
-  }
-  if ( csvOrder[ 0 ] != 0 ) {
-    fprintf( stderr, "*** First CSV header field name '%s' is not the channel number ***\n",
-                     csvField[ csvOrder[ 0 ] ].fieldName );
-    return false;
+    if ( loading.pPlan != 0 ) {     // so a skipped line leaves this image alone
+      delete loading.pTrial;
+      loading.pTrial = clone();
+    }
+    loading.offset = getOffset();
+    loading.count  = 0;
+    loading.fields = 0;
+    loading.bytes   = Stats::isEnabled ? strlen( line ) : 0;
+    loading.errors  = 0;
+    loading.skipped = 0;
   }
 
-  size_t count = 0;
-  size_t offset = getOffset();
-  while ( fgets( line, sizeof line, pFile ) != 0 ) {
-    pNext = line;
+  size_t const offset = loading.offset;
+  for (  ;  lines > 0;  lines-- ) {
+    if ( input.gets( line, sizeof line ) == 0 ) {
+      Stats::add( Stats::BYTES_IN,     loading.bytes  );
+      Stats::add( Stats::CHANNELS,     loading.count  );
+      Stats::add( Stats::FIELDS,       loading.fields );
+      Stats::add( Stats::PARSE_ERRORS, loading.errors );
+      status( "--- Lines loaded: %d ---\n", (int)loading.count );
+      if ( loading.skipped > 0 ) {
+        status( "--- Lines outside the channel ranges: %d ---\n", (int)loading.skipped );
+      }
+      return DONE;
+    }
+    if ( Stats::isEnabled ) {
+      loading.bytes += strlen( line );
+    }
+    char * pNext = line;
     char * pTemp;
     size_t lineIndex = strtoul( parse( & pNext ), & pTemp, 10 ) - offset;
-    if ( *pTemp != 0  || !(this->*csvField[ 0 ].setField)( lineIndex, pNext ) ) {
-      fprintf( stderr, "*** Channel %d: Invalid number; line skipped ***\n", (int)(lineIndex + offset) );
+    if ( loading.pRanges != 0  &&  *pTemp == 0  &&  !loading.pRanges->contains( lineIndex + offset ) ) {
+      loading.skipped++;
       continue;
     }
+    Radio      * pTrial  = loading.pTrial;
+    Radio      * pTarget = pTrial != 0 ? pTrial : this;
+    bool         isKept  = loading.pPlan != 0  &&  *pNext != 0  &&  lineIndex < getCount()  &&  getValid( lineIndex );
+    char const * pValid  = *pNext != 0 ? "1" : "";    // whether the line puts the channel in use
+    if ( *pTemp != 0  || !(isKept  ||  (pTarget->*csvField[ 0 ].setField)( lineIndex, pValid )) ) {
+      diagnose( Diagnostic::INVALID_CHANNEL, (int)(lineIndex + offset), csvField[ 0 ].fieldName,
+                "Channel %d: Invalid number; line skipped", (int)(lineIndex + offset) );
+      loading.errors++;
+      continue;
+    }
+    char * values[ COUNT_OF( loading.order ) ];
+    size_t fieldIndex = 1;
     if ( *pNext != 0 ) {
-      count++;
-      for ( size_t fieldIndex = 1;  fieldIndex < csvFieldCount;  fieldIndex++ ) {
-        char * pTemp = parse( & pNext );
-        if ( !(this->*csvField[ csvOrder[ fieldIndex ] ].setField)( lineIndex, pTemp ) ) {
-          fprintf( stderr, "*** Channel %d, field '%s': Invalid field contents '%s'; line skipped ***\n",
-                           (int)(lineIndex + offset), csvField[ csvOrder[  fieldIndex ] ].fieldName, pTemp );
-          (this->*csvField[ 0 ].setField)( lineIndex, 0 );
-          count--;
+      loading.count++;
+      for (  ;  fieldIndex < loading.columns;  fieldIndex++ ) {
+        char * pTemp = values[ fieldIndex ] = parse( & pNext );
+        if ( loading.order[ fieldIndex ] == Loading::SKIPPED ) {
+          continue;
+        }
+        CsvField const & field = csvField[ loading.order[ fieldIndex ] ];
+        if ( !(pTarget->*field.setField)( lineIndex, pTemp ) ) {
+          diagnose( Diagnostic::INVALID_FIELD, (int)(lineIndex + offset), field.fieldName,
+                    "Channel %d, field '%s': Invalid field contents '%s'; line skipped",
+                    (int)(lineIndex + offset), field.fieldName, pTemp );
+          if ( pTrial != 0 ) {
+            pTrial->rebind( pHeader, pData, size );     // undo the try
+          } else if ( !isKept ) {
+            (this->*csvField[ 0 ].setField)( lineIndex, 0 );
+          }
+          loading.count--;
+          loading.errors++;
           break;
         }
+        loading.fields++;
       }
     }
+    if ( pTrial != 0  &&  (*pValid == 0  ||  fieldIndex == loading.columns) ) {  // the try worked:  now for real
+      if ( !isKept ) {
+        (this->*csvField[ 0 ].setField)( lineIndex, pValid );
+      }
+      for ( fieldIndex = 1;  *pValid != 0  &&  fieldIndex < loading.columns;  fieldIndex++ ) {
+        if ( loading.order[ fieldIndex ] != Loading::SKIPPED ) {
+          (this->*csvField[ loading.order[ fieldIndex ] ].setField)( lineIndex, values[ fieldIndex ] );
+        }
+      }
+    }
+  }
+  return MORE;
+}
+
+bool Radio::Ranges::parse( char const * pText,
+                           bool         isOrdered ) {
+  char const * pStart = pText;
+  count = 0;
+  while ( *pText != 0 ) {
+    char * pTemp;
+    size_t from = strtoul( pText, & pTemp, 10 ),
+           to   = from;
+    if ( pTemp == pText  ||  !isdigit( *pText ) ) {
+      break;
+    }
+    pText = pTemp;
+    if ( *pText == '-' ) {
+      to = strtoul( ++pText, & pTemp, 10 );
+      if ( pTemp == pText  ||  !isdigit( *pText )  ||  to < from ) {
+        break;
+      }
+      pText = pTemp;
+    }
+    if ( *pText != 0  &&  *pText++ != ',' ) {
+      break;
+    }
+    if ( isOrdered ) {                  // append, as given;  a channel only once
+      for ( size_t index = 0;  index < count;  index++ ) {
+        if ( first[ index ] <= to  &&  from <= last[ index ] ) {
+          fprintf( stderr, "*** Parameter error;  channel %d is in '%s' twice ***\n",
+                   (int)(from > first[ index ] ? from : first[ index ]), pStart );
+          return false;
+        }
+      }
+      if ( count == MAX_RANGES ) {
+        fprintf( stderr, "*** Too many channel ranges;  at most %d ***\n", (int)MAX_RANGES );
+        return false;
+      }
+      first[ count ]  = from;
+      last[  count++ ] = to;
+      continue;
+    }
+    size_t index = 0;                   // insert in order, merging what it touches
+    while ( index < count  &&  last[ index ] + 1 < from ) {
+      index++;
+    }
+    size_t end = index;
+    while ( end < count  &&  first[ end ] <= to + 1 ) {
+      from = first[ end ] < from ? first[ end ] : from;
+      to   = last[  end ] > to   ? last[  end ] : to;
+      end++;
+    }
+    if ( end == index ) {               // a new range
+      if ( count == MAX_RANGES ) {
+        fprintf( stderr, "*** Too many channel ranges;  at most %d ***\n", (int)MAX_RANGES );
+        return false;
+      }
+      memmove( & first[ index + 1 ], & first[ index ], (count - index) * sizeof first[ 0 ] );
+      memmove( & last[  index + 1 ], & last[  index ], (count - index) * sizeof last[  0 ] );
+      count++;
+      end++;
+    }
+    first[ index ] = from;
+    last[  index ] = to;
+    memmove( & first[ index + 1 ], & first[ end ], (count - end) * sizeof first[ 0 ] );
+    memmove( & last[  index + 1 ], & last[  end ], (count - end) * sizeof last[  0 ] );
+    count -= end - index - 1;
+  }
+  if ( *pText != 0  ||  count == 0 ) {
+    fprintf( stderr, "*** Invalid channel ranges '%s';  e.g. 100-199,500 ***\n", pStart );
+    return false;
   }
-  fprintf( stderr, "--- Lines loaded: %d ---\n", (int)count );
   return true;
 }
 
-void Radio::dump( FILE * pFile ) const {
+bool Radio::Ranges::contains( size_t channel ) const {
+  size_t low  = 0,
+         high = count;
+  while ( low < high ) {                // the first range that ends at or after it
+    size_t middle = (low + high) / 2;
+    if ( last[ middle ] < channel ) {
+      low  = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return low < count  &&  first[ low ] <= channel;
+}
+
+bool Radio::Ranges::fits( Radio const * pRadio ) const {
+  size_t const offset = pRadio->getOffset(),
+               end    = offset + pRadio->getCount();     // one past the last channel
+  for ( size_t index = 0;  index < count;  index++ ) {
+    if ( first[ index ] < offset  ||  last[ index ] >= end ) {
+      size_t channel = first[ index ] < offset ? first[ index ] : (first[ index ] < end ? end : first[ index ]);
+      fprintf( stderr, "*** Channel %d is not on this radio;  its channels are %d-%d ***\n",
+               (int)channel, (int)offset, (int)(end - 1) );
+      return false;
+    }
+  }
+  return true;
+}
+
+uint8_t * Radio::Ranges::select( Radio   const * pRadio,
+                                 uint8_t const * pSelect,
+                                 Arena         & arena ) const {
+  size_t const offset   = pRadio->getOffset(),
+               channels = pRadio->getCount();
+  uint8_t    * pFlags   = (uint8_t *)arena.allocate( channels + 1 );
+  memset( pFlags, 0, channels );
+  for ( size_t index = 0;  index < count;  index++ ) {
+    for ( size_t channel = first[ index ] < offset ? offset : first[ index ];
+          channel <= last[ index ]  &&  channel - offset < channels;  channel++ ) {
+      pFlags[ channel - offset ] = pSelect == 0  ||  pSelect[ channel - offset ];
+    }
+  }
+  return pFlags;
+}
+
+void Radio::dump( Output         & output,
+                  Ranges   const & ranges,
+                  uint8_t  const * pSelect,
+                  CsvField const * pPlan ) const {
+  size_t const offset  = getOffset();
+  size_t       next    = 0;
+  bool         isFirst = true;              // the CSV header line is still to go
+  for ( size_t index = 0;  index < ranges.count;  index++ ) {
+    size_t from = ranges.first[ index ] < offset ? 0 : ranges.first[ index ] - offset;
+    if ( ranges.last[ index ] < offset ) {
+      continue;
+    }
+    if ( from >= getCount() ) {
+      break;
+    }
+    if ( isFirst  &&  from > 0 ) {
+      dump( output, next, 0, pSelect, pPlan );   // just the header;  a slice from 0 has it
+    }
+    isFirst = false;
+    next    = from;
+    dump( output, next, ranges.last[ index ] - offset - from + 1, pSelect, pPlan );
+  }
+  if ( isFirst ) {
+    dump( output, next, 0, pSelect, pPlan );
+  }
+}
+
+CsvField const * Radio::project( char const * pNames,
+                                 Arena      & arena ) const {
   CsvField const * const csvField = csvHeader();
+  size_t count = 0;
+  for (  ;  csvField[ count ].fieldName != 0;  count++ );
+  CsvField * pPlan  = (CsvField *)arena.allocate( (count + 1) * sizeof (CsvField) );
+  size_t     fields = 1;
+  memcpy( (void *)& pPlan[ 0 ], & csvField[ 0 ], sizeof (CsvField) );   // the channel number
+  while ( *pNames != 0 ) {
+    char   name[ 256 ];
+    size_t length = strcspn( pNames, "," );
+    while ( length > 0  &&  isspace( pNames[ length - 1 ] ) ) {
+      length--;
+    }
+    while ( isspace( *pNames )  &&  length > 0 ) {
+      pNames++;
+      length--;
+    }
+    if ( length >= sizeof name ) {
+      length = sizeof name - 1;
+    }
+    memcpy( name, pNames, length );
+    name[ length ] = 0;
+    pNames += strcspn( pNames, "," );
+    pNames += *pNames == ',';
+    size_t fieldIndex = 0;
+    while ( csvField[ fieldIndex ].fieldName != 0  &&  stricmp( name, csvField[ fieldIndex ].fieldName ) != 0 ) {
+      fieldIndex++;
+    }
+    if ( csvField[ fieldIndex ].fieldName == 0 ) {
+      fprintf( stderr, "*** Unknown CSV field name '%s'; fields:", name );
+      for ( fieldIndex = 0;  csvField[ fieldIndex ].fieldName != 0;  fieldIndex++ ) {
+        fprintf( stderr, "%s %s", fieldIndex ? "," : "", csvField[ fieldIndex ].fieldName );
+      }
+      fprintf( stderr, " ***\n" );
+      return 0;
+    }
+    size_t planIndex = 0;
+    while ( planIndex < fields  &&  pPlan[ planIndex ].fieldName != csvField[ fieldIndex ].fieldName ) {
+      planIndex++;
+    }
+    if ( planIndex == fields ) {        // not listed already
+      memcpy( (void *)& pPlan[ fields++ ], & csvField[ fieldIndex ], sizeof (CsvField) );
+    }
+  }
+  memset( (void *)& pPlan[ fields ], 0, sizeof (CsvField) );
+  return pPlan;
+}
+
+void Radio::dump( Output & output ) const {
+  size_t next = 0;
+  dump( output, next, (size_t)-1 );
+}
+
+Radio::Progress Radio::dump( Output         & output,
+                             size_t         & next,
+                             size_t           channels,
+                             uint8_t  const * pSelect,
+                             CsvField const * pPlan ) const {
+  Stats::Span span( Stats::DUMP );
+  CsvField const * const csvField = pPlan ? pPlan : csvHeader();
   size_t csvFieldCount = 0;
+  size_t bytes = 0;
   for (  ;  csvField[ csvFieldCount ].fieldName != 0;  csvFieldCount++ ) {
+    if ( next > 0 ) {
+      continue;
+    }
     if ( csvFieldCount > 0 ) {
-      fputc( ',', pFile );
+      output.putc( ',' );
+      bytes++;
     }
-    fprintf( pFile, "%s", csvField[ csvFieldCount ].fieldName );
+    bytes += output.printf( "%s", csvField[ csvFieldCount ].fieldName );
+  }
+  if ( next == 0 ) {
+    output.putc( '\n' );
+    bytes++;
   }
-  fputc( '\n', pFile );
   size_t offset = getOffset();
-  for ( size_t lineIndex = 0;  lineIndex < getCount();  lineIndex++ ) {
-    if ( (this->*csvField[ 0 ].getField)( lineIndex, 0 ) ) {
+  size_t last   = getCount() - next > channels ? next + channels : getCount();
+  size_t count  = 0,
+         errors = 0;
+  for (  ;  next < last;  next++ ) {
+    size_t lineIndex = next;
+    if ( (pSelect == 0  ||  pSelect[ lineIndex ])  &&  (this->*csvField[ 0 ].getField)( lineIndex, 0 ) ) {
       char work[ 1024 ];
       sprintf( work, "%d", (int)(lineIndex + offset) );
       for ( size_t fieldIndex = 1;  fieldIndex < csvFieldCount;  fieldIndex++ ) {
-        fprintf( pFile, "%s,", work );
+        bytes += output.printf( "%s,", work );
         if ( !(this->*csvField[ fieldIndex ].getField)( lineIndex, work ) ) {
-          fprintf( stderr, "*** Channel %d, field '%s': Unknown field value '%s' ***\n",
-                           (int)(lineIndex + offset), csvField[ fieldIndex ].fieldName, work );
+          diagnose( Diagnostic::UNKNOWN_FIELD_VALUE, (int)(lineIndex + offset), csvField[ fieldIndex ].fieldName,
+                    "Channel %d, field '%s': Unknown field value '%s'",
+                    (int)(lineIndex + offset), csvField[ fieldIndex ].fieldName, work );
+          errors++;
         }
       }
-      fprintf( pFile, "%s\n", work );
+      bytes += output.printf( "%s\n", work );
+      count++;
     }
   }
+  Stats::add( Stats::BYTES_OUT,    bytes  );
+  Stats::add( Stats::CHANNELS,     count  );
+  Stats::add( Stats::FIELDS,       count * (csvFieldCount - 1) );
+  Stats::add( Stats::PARSE_ERRORS, errors );
+  return next < getCount() ? MORE : DONE;
 }
 
-void Radio::save( FILE * pFile, bool isBinary, char const * pComment ) {
+void Radio::save( Output & output, bool isBinary, char const * pComment ) {
+  Stats::Span span( Stats::SAVE );
   char const * pModel = setComment( pComment );
+  size_t       bytes  = size;
   if ( isBinary ) {
-    fwrite( pData, 1, size, pFile );
+    output.write( pData, size );
   } else {
-    fputs( pHeader, pFile );
+    output.puts( pHeader );
+    bytes = strlen( pHeader );
     size_t maxLength = size > 0x10000 ? 0x20 : 0x10;
     for ( size_t address = 0;  address < size;  ) {
       size_t length = size - address < maxLength
                     ? size - address : maxLength;
-      fprintf( pFile, size > 0x10000 ? "%08X%02X" : "%04X%02X", (int)address, (int)length );
+      char work[ 2 * 0x20 + 1 ];
+      bytes += output.printf( size > 0x10000 ? "%08X%02X" : "%04X%02X", (int)address, (int)length );
       for ( size_t index = 0;  index < length;  index++ ) {
-        fprintf( pFile, "%02X", pData[ address++ ] & UCHAR_MAX );
+        work[ index * 2     ] = "0123456789ABCDEF"[ pData[ address   ] >> 4 & 0xF ];
+        work[ index * 2 + 1 ] = "0123456789ABCDEF"[ pData[ address++ ]      & 0xF ];
       }
-      fputc( '\n', pFile );
+      work[ length * 2 ] = '\n';
+      output.write( work, length * 2 + 1 );
+      bytes += length * 2 + 1;
     }
   }
+  Stats::add( Stats::BYTES_OUT, bytes );
   if ( pComment == 0 ) {
-    fprintf( stderr, "--- %s updated ---\n", pModel );
+    status( "--- %s updated ---\n", pModel );
   } else {
-    fprintf( stderr, "--- %s ('%s') updated ---\n", pModel, pComment );
+    status( "--- %s ('%s') updated ---\n", pModel, pComment );
   }
 }
 
-Radio * Radio::create( FILE * pFile, bool isBinary ) {
-  new_t     ** models;
-  uint8_t      memory[ 1048576 ];
-  char         header[ 1000 ],
-               work[ 256 ];
-  size_t       address = 0,
-               count;
+void Radio::digest( uint8_t * pDigest ) const {
+  Sha256 sha256;
+  sha256.update( pHeader, strlen( pHeader ) );
+  sha256.update( pData,   size );
+  sha256.final(  pDigest );
+}
 
-  if ( isBinary ) {
-    address = fread( memory, 1, sizeof memory, pFile );
-    models = binModels;
-    count = COUNT_OF( binModels );
-  } else {
-    char line[ 1024 ];
-    for ( size_t index = 0;  fgets( line, sizeof line, pFile );  index += strlen( line ) ) {
-      if ( index > 0  &&  line[ 0 ] != '#' ) {
-        break;
-      }
-      if ( index > sizeof header - sizeof line ) {
-        fprintf( stderr, "*** Invalid file format (file header size) *** \n" );
-        return NULL;
-      }
-      strcpy( & header[ index ], line );
-    }
-    do {
-      if ( line[ 0 ] != '#' ) {
-        memcpy( work, line, 10 );
-        size_t length = strlen( line );
-        for ( ;  length > 0  &&  line[ length - 1 ] < ' ';  line[ --length ] = 0 ); 
-        size_t index = length % 0x10;
-        index = index < 6 ? 6 : index;  // special-case ID-1 last line
-        work[ index ] = 0;
-        char * pTemp;
-        count    = strtoul( & work[ index - 2 ], & pTemp, 0x10 );
-        work[ index - 2 ] = 0;
-        size_t location = strtoul( & work[ 0  ], & pTemp, 0x10 );
-        if ( location + count >= sizeof memory ) {
-          fprintf( stderr, "*** Input file too large ***\n  %s", line );
-          return NULL;
-        }
-        if ( length != index + count * 2
-            ||  location != address
-            ||  address + count >= sizeof memory ) {
-          fprintf( stderr, "*** Invalid input file data line format ***\n  %s", line );
-          fprintf( stderr, "\n  %d %d %d ", (int)length, (int)index, (int)count );
-          return NULL;
-        }
-        work[ 2 ] = 0;
-        while ( index < length ) {
-          work[ 0 ] = line[ index++ ];
-          work[ 1 ] = line[ index++ ];
-          memory[ address++ ] = strtoul( work, & pTemp, 0x10 );
-        }
-      }
-    } while ( fgets( line, sizeof line, pFile ) );
-    models = icfModels;
-    count = COUNT_OF( icfModels );
+bool Radio::rebind( char const    * pHeader,
+                    uint8_t const * pData,
+                    size_t          size ) {
+  size_t length = strlen( pHeader ) + 1;
+  if ( size != this->size ) {
+    return false;
   }
-  Radio      * pRadio;
+  if ( length > headerLimit ) {
+    free( (void *)this->pHeader );
+    this->pHeader = (char *)malloc( length );
+    headerLimit   = length;
+  }
+  memcpy( (char *)this->pHeader, pHeader, length );
+  memcpy( this->pData,           pData,   size   );
+  return true;
+}
+
+Radio * Radio::clone( void ) const {
+  if ( model >= MODELS ) {
+    return 0;
+  }
+  new_t * pNew   = model < COUNT_OF( icfModels ) ? icfModels[ model ] : binModels[ model - COUNT_OF( icfModels ) ];
+  Radio * pRadio = pNew( pHeader, pData, size, 0 );
+  if ( pRadio != 0 ) {
+    pRadio->model   = model;
+    pRadio->present = present;
+  }
+  return pRadio;
+}
+
+Radio * Radio::create( char const    * pHeader,
+                       uint8_t const * pData,
+                       size_t          size,
+                       bool            isBinary,
+                       Radio        ** pIdle ) {
+  new_t ** models = isBinary ? binModels            : icfModels;
+  size_t   count  = isBinary ? COUNT_OF( binModels ) : COUNT_OF( icfModels );
+  size_t   first  = isBinary ? COUNT_OF( icfModels ) : 0;   // Pool slots
+  char     work[ 256 ];
+  Stats::Span span( Stats::DETECT );
+
+  assert( COUNT_OF( binModels ) + COUNT_OF( icfModels ) <= MODELS );
   for ( size_t index = 0;  index < count;  index++ ) {
-    pRadio = models[ index ]( header, memory, address );
+    Radio * pRadio = models[ index ]( pHeader, pData, size, pIdle ? pIdle[ first + index ] : 0 );
     if ( pRadio ) {
+      pRadio->model   = first + index;
+      if ( pIdle != 0 ) {
+        pIdle[ first + index ] = 0;    // rebound, or replaced
+      }
       char const * pModel = pRadio->getComment( work );
       for ( size_t index = strlen( work );  index-- > 0  &&  work[ index ] == ' ';  work[ index ] = 0 );
       if ( work[ 0 ] == 0 ) {
-        fprintf( stderr, "=== %s found ===\n", pModel );
+        status( "=== %s found ===\n", pModel );
       } else {
-        fprintf( stderr, "=== %s ('%s') found ===\n", pModel, work );
+        status( "=== %s ('%s') found ===\n", pModel, work );
       }
       return pRadio;
     }
   }
-  fprintf( stderr, "*** File does not match any known radio ***\n" );
+  diagnose( Diagnostic::UNKNOWN_RADIO, -1, 0, "File does not match any known radio" );
   return NULL;
 }
 
+Decoder::Decoder( Input & input,
+                  bool    isBinary,
+                  Arena & scratch )
+    : input( input ), address( 0 ), isBinary( isBinary ), isStarted( false ), hasLine( false ) {
+  scratch.reset();
+  pMemory = (uint8_t *)scratch.allocate( Radio::MAX_IMAGE  );
+  pHeader = (char    *)scratch.allocate( Radio::MAX_HEADER );
+}
+
+Radio::Progress Decoder::step( size_t lines ) {
+  char         work[ 256 ];
+  size_t       bytes = 0,
+               count;
+  Stats::Span  span( Stats::DECODE );
+
+  if ( !isStarted ) {
+    isStarted = true;
+    if ( isBinary ) {
+      pHeader[ 0 ] = 0;
+      address = input.read( pMemory, Radio::MAX_IMAGE );
+      Stats::add( Stats::BYTES_IN, address );
+      return Radio::DONE;
+    }
+    line[ 0 ] = 0;
+    for ( bytes = 0;  input.gets( line, sizeof line );  bytes += strlen( line ) ) {   // "bytes":  the header so far
+      if ( bytes > 0  &&  line[ 0 ] != '#' ) {
+        break;
+      }
+      if ( bytes > Radio::MAX_HEADER - sizeof line ) {
+        diagnose( Diagnostic::INVALID_FILE_HEADER, -1, 0, "Invalid file format (file header size)" );
+        return Radio::FAILED;
+      }
+      strcpy( & pHeader[ bytes ], line );
+    }
+    hasLine = true;       // the line after the header, or else the last header line
+  }
+  for (  ;  hasLine  &&  lines > 0;  lines-- ) {
+    size_t length = strlen( line );     // needed by a data line anyway
+    bytes += length;
+    if ( line[ 0 ] != '#' ) {
+      memcpy( work, line, 10 );
+      for ( ;  length > 0  &&  line[ length - 1 ] < ' ';  line[ --length ] = 0 ); 
+      size_t index = length % 0x10;
+      index = index < 6 ? 6 : index;  // special-case ID-1 last line
+      work[ index ] = 0;
+      char * pTemp;
+      count    = strtoul( & work[ index - 2 ], & pTemp, 0x10 );
+      work[ index - 2 ] = 0;
+      size_t location = strtoul( & work[ 0  ], & pTemp, 0x10 );
+      if ( location + count >= Radio::MAX_IMAGE ) {
+        diagnose( Diagnostic::FILE_TOO_LARGE, -1, 0, "Input file too large:  %s", line );
+        return Radio::FAILED;
+      }
+      if ( length != index + count * 2
+          ||  location != address
+          ||  address + count >= Radio::MAX_IMAGE ) {
+        diagnose( Diagnostic::INVALID_DATA_LINE, -1, 0, "Invalid input file data line format:  %s  (%d %d %d)",
+                  line, (int)length, (int)index, (int)count );
+        return Radio::FAILED;
+      }
+      work[ 2 ] = 0;
+      while ( index < length ) {
+        work[ 0 ] = line[ index++ ];
+        work[ 1 ] = line[ index++ ];
+        pMemory[ address++ ] = strtoul( work, & pTemp, 0x10 );
+      }
+    }
+    hasLine = input.gets( line, sizeof line ) != 0;
+  }
+  Stats::add( Stats::BYTES_IN, bytes );
+  return hasLine ? Radio::MORE : Radio::DONE;
+}
+
+Radio * Radio::create( Input & input, bool isBinary, Radio ** pIdle, Arena * pScratch ) {
+  Arena   local( 0 );     // when the caller has no scratch Arena
+  Decoder decoder( input, isBinary, pScratch ? *pScratch : local );
+  if ( decoder.step( (size_t)-1 ) != DONE ) {
+    return NULL;
+  }
+  return create( decoder.getHeader(), decoder.getData(), decoder.getSize(), isBinary, pIdle );
+}
+
+bool isBinaryName( char const * pName ) {
+  char   Icf[]    = ".ICF";
+  bool   isBinary = false;
+  size_t offset   = strlen( pName ) - (sizeof Icf - 1);
+  if ( (int)offset > 0 ) {
+    for ( size_t index = 0;  index < sizeof Icf;  ) {
+      isBinary |= toupper( pName[ offset++ ] ) != Icf[ index++ ];
+    }
+  }
+  return isBinary;
+}
+
+#ifndef RADIO2CSV_LIBRARY  // the command line;  "make lib" builds without it
+
+static Radio * openRadio( char const * pName,
+                          bool       * pIsBinary ) {
+  FILE * pFile = fopen( pName, "rb" );
+  if ( pFile == 0 ) {
+    fprintf( stderr, "*** File not found: '%s' ***\n", pName );
+    return 0;
+  }
+  *pIsBinary = isBinaryName( pName );
+  Stats::setFile( pName );
+  Radio * pRadio = Radio::create( pFile, *pIsBinary );
+  fclose( pFile );
+  return pRadio;
+}
+
+static int storeCommand( int                argc,
+                         char const * const argv[] ) {
+  if ( argc < 4 ) {
+    fprintf( stderr, "*** Parameter error;  too few parameters ***\n" );
+    return 3;
+  }
+  Store store( argv[ 2 ] );
+  for ( int index = 3;  index < argc;  index++ ) {
+    bool    isBinary;
+    Radio * pRadio = openRadio( argv[ index ], & isBinary );
+    char    id[ Sha256::HEX_SIZE ];
+    if ( pRadio == 0  ||  !store.put( pRadio, isBinary, id ) ) {
+      delete pRadio;
+      return 2;
+    }
+    printf( "%s  %s\n", id, argv[ index ] );
+    delete pRadio;
+  }
+  return 0;
+}
+
+static int restoreCommand( int                argc,
+                           char const * const argv[] ) {
+  if ( argc < 4  ||  argc > 6 ) {
+    fprintf( stderr, "*** Parameter error;  wrong number of parameters ***\n" );
+    return 3;
+  }
+  Store   store( argv[ 2 ] );
+  bool    isBinary;
+  Radio * pRadio = store.get( argv[ 3 ], & isBinary );
+  if ( pRadio == 0 ) {
+    return 2;
+  }
+  if ( argc > 4 ) {
+    FILE * pFile = fopen( argv[ 4 ], "wb" );
+    if ( pFile == 0 ) {
+      fprintf( stderr, "*** Unable to write file: '%s' ***\n", argv[ 4 ] );
+      delete pRadio;
+      return 2;
+    }
+    pRadio->save( pFile, isBinary, argv[ 5 ] );
+    fclose( pFile );
+  } else {
+    pRadio->dump( stdout );
+  }
+  delete pRadio;
+  return 0;
+}
+
+static int diffCommand( int                argc,
+                        char const * const argv[] ) {
+  if ( argc != 5 ) {
+    fprintf( stderr, "*** Parameter error;  wrong number of parameters ***\n" );
+    return 3;
+  }
+  bool    isBinary;
+  Radio * pBase   = openRadio( argv[ 2 ], & isBinary );
+  Radio * pTarget = pBase ? openRadio( argv[ 3 ], & isBinary ) : 0;
+  FILE  * pFile   = pTarget ? fopen( argv[ 4 ], "wb" ) : 0;
+  int     result  = 2;
+  if ( pTarget != 0  &&  pFile == 0 ) {
+    fprintf( stderr, "*** Unable to write file: '%s' ***\n", argv[ 4 ] );
+  } else if ( pFile != 0 ) {
+    result = Delta::make( pBase, pTarget, pFile ) ? 0 : 2;
+    result = fclose( pFile ) == 0 ? result : 2;
+  }
+  delete pBase;
+  delete pTarget;
+  return result;
+}
+
+static int patchCommand( int                argc,
+                         char const * const argv[] ) {
+  if ( argc < 5  ||  argc > 6 ) {
+    fprintf( stderr, "*** Parameter error;  wrong number of parameters ***\n" );
+    return 3;
+  }
+  bool    isBinary;
+  Radio * pRadio = openRadio( argv[ 2 ], & isBinary );
+  if ( pRadio == 0 ) {
+    return 2;
+  }
+  FILE  * pFile  = fopen( argv[ 3 ], "rb" );
+  if ( pFile == 0 ) {
+    fprintf( stderr, "*** File not found: '%s' ***\n", argv[ 3 ] );
+    delete pRadio;
+    return 2;
+  }
+  bool isOk = Delta::apply( pRadio, pFile );
+  fclose( pFile );
+  if ( isOk ) {
+    pFile = fopen( argv[ 4 ], "wb" );
+    if ( pFile == 0 ) {
+      fprintf( stderr, "*** Unable to write file: '%s' ***\n", argv[ 4 ] );
+      isOk = false;
+    } else {
+      pRadio->save( pFile, isBinary, argv[ 5 ] );
+      fclose( pFile );
+    }
+  }
+  delete pRadio;
+  return isOk ? 0 : 2;
+}
+
+static int convertCommand( int                argc,
+                           char const * const argv[] ) {
+  if ( argc < 5  ||  argc > 6 ) {
+    fprintf( stderr, "*** Parameter error;  wrong number of parameters ***\n" );
+    return 3;
+  }
+  bool    isBinary;
+  Radio * pSource = openRadio( argv[ 2 ], & isBinary );
+  Radio * pTarget = pSource ? openRadio( argv[ 3 ], & isBinary ) : 0;
+  FILE  * pFile   = pTarget ? fopen( argv[ 4 ], "wb" ) : 0;
+  int     result  = 2;
+  if ( pTarget != 0  &&  pFile == 0 ) {
+    fprintf( stderr, "*** Unable to write file: '%s' ***\n", argv[ 4 ] );
+  } else if ( pFile != 0 ) {
+    Convert::run( pSource, pTarget );
+    Stats::setFile( argv[ 4 ] );
+    pTarget->save( pFile, isBinary, argv[ 5 ] );
+    result = fclose( pFile ) == 0 ? 0 : 2;
+  }
+  delete pSource;
+  delete pTarget;
+  return result;
+}
+
+static int compactCommand( int                argc,
+                           char const * const argv[] ) {
+  Radio::Ranges ranges;
+  char const  * pOrder        = 0;
+  bool          isRenumbering = false;
+  for (  ;  argc > 2  &&  strncmp( argv[ 2 ], "--", 2 ) == 0;  argv++, argc-- ) {
+    if ( argc > 3  &&  strcmp( argv[ 2 ], "--order" ) == 0 ) {
+      pOrder = argv[ 3 ];
+      argv++;
+      argc--;
+    } else if ( strcmp( argv[ 2 ], "--banks" ) == 0 ) {
+      isRenumbering = true;
+    } else {
+      break;
+    }
+  }
+  if ( pOrder != 0  &&  !ranges.parse( pOrder, true ) ) {
+    return 3;
+  }
+  if ( argc < 4  ||  argc > 5 ) {
+    fprintf( stderr, "*** Parameter error;  wrong number of parameters ***\n" );
+    return 3;
+  }
+  bool    isBinary;
+  Radio * pRadio = openRadio( argv[ 2 ], & isBinary );
+  int     result = 2;
+  if ( pRadio != 0  &&  ranges.fits( pRadio )
+                    &&  Compact::run( pRadio, ranges.count ? & ranges : 0, isRenumbering ) != (size_t)-1 ) {
+    FILE * pFile = fopen( argv[ 3 ], "wb" );
+    if ( pFile == 0 ) {
+      fprintf( stderr, "*** Unable to write file: '%s' ***\n", argv[ 3 ] );
+    } else {
+      Stats::setFile( argv[ 3 ] );
+      pRadio->save( pFile, isBinary, argv[ 4 ] );
+      result = fclose( pFile ) == 0 ? 0 : 2;
+    }
+  }
+  delete pRadio;
+  return result;
+}
+
+static int sortCommand( int                argc,
+                        char const * const argv[] ) {
+  if ( argc < 5  ||  argc > 6 ) {
+    fprintf( stderr, "*** Parameter error;  wrong number of parameters ***\n" );
+    return 3;
+  }
+  int key = Sort::keyOf( argv[ 2 ] );
+  if ( key < 0 ) {
+    return 3;
+  }
+  bool    isBinary;
+  Radio * pRadio = openRadio( argv[ 3 ], & isBinary );
+  int     result = 2;
+  if ( pRadio != 0  &&  Sort::run( pRadio, (Sort::Key)key ) != (size_t)-1 ) {
+    FILE * pFile = fopen( argv[ 4 ], "wb" );
+    if ( pFile == 0 ) {
+      fprintf( stderr, "*** Unable to write file: '%s' ***\n", argv[ 4 ] );
+    } else {
+      Stats::setFile( argv[ 4 ] );
+      pRadio->save( pFile, isBinary, argv[ 5 ] );
+      result = fclose( pFile ) == 0 ? 0 : 2;
+    }
+  }
+  delete pRadio;
+  return result;
+}
+
+static int dupesCommand( int                argc,
+                         char const * const argv[] ) {
+  char const * pDirectory = 0;
+  if ( argc > 3  &&  strcmp( argv[ 2 ], "--consolidate" ) == 0 ) {
+    pDirectory = argv[ 3 ];
+    argv += 2;
+    argc -= 2;
+  }
+  if ( argc < 3 ) {
+    fprintf( stderr, "*** Parameter error;  too few parameters ***\n" );
+    return 3;
+  }
+  Dedupe dedupe;
+  bool   isBinary;
+  for ( int index = 2;  index < argc;  index++ ) {
+    Radio * pRadio = openRadio( argv[ index ], & isBinary );
+    if ( pRadio == 0 ) {
+      return 2;
+    }
+    dedupe.add( pRadio );
+    delete pRadio;
+  }
+  FileOutput output( stdout );
+  dedupe.report( output, & argv[ 2 ] );
+  for ( int index = 2;  pDirectory != 0  &&  index < argc;  index++ ) {   // each image with spares, again
+    Radio * pRadio = openRadio( argv[ index ], & isBinary );
+    size_t  count  = pRadio ? dedupe.consolidate( pRadio, index - 2 ) : 0;
+    if ( count > 0 ) {
+      char         path[ 4096 ];
+      char const * pBase = strrchr( argv[ index ], '/' );
+      pBase = pBase ? pBase + 1 : argv[ index ];
+      snprintf( path, sizeof path, "%s/%s", pDirectory, pBase );
+      FILE * pFile = fopen( path, "wb" );
+      if ( pFile == 0 ) {
+        fprintf( stderr, "*** Unable to write file: '%s' ***\n", path );
+        delete pRadio;
+        return 2;
+      }
+      status( "--- %s:  %d duplicates taken out of use ---\n", argv[ index ], (int)count );
+      Stats::setFile( path );
+      pRadio->save( pFile, isBinary, 0 );
+      fclose( pFile );
+    }
+    delete pRadio;
+  }
+  return 0;
+}
+
+static int mergeCommand( int                argc,
+                         char const * const argv[] ) {
+  unsigned policy = 0;
+  for (  ;  argc > 2  &&  strncmp( argv[ 2 ], "--", 2 ) == 0;  argc--, argv++ ) {
+    if ( strcmp( argv[ 2 ], "--relocate" ) == 0 ) {
+      policy |= Merge::RELOCATE;
+    } else if ( strcmp( argv[ 2 ], "--dedupe" ) == 0 ) {
+      policy |= Merge::DEDUPE;
+    } else {
+      fprintf( stderr, "*** Parameter error;  unknown merge policy '%s' ***\n", argv[ 2 ] );
+      return 3;
+    }
+  }
+  if ( argc < 4 ) {
+    fprintf( stderr, "*** Parameter error;  too few parameters ***\n" );
+    return 3;
+  }
+  Radio * pRadio = Merge::run( argc - 3, & argv[ 3 ], policy );
+  if ( pRadio == 0 ) {
+    return 2;
+  }
+  FILE  * pFile  = fopen( argv[ 2 ], "wb" );
+  if ( pFile == 0 ) {
+    fprintf( stderr, "*** Unable to write file: '%s' ***\n", argv[ 2 ] );
+    delete pRadio;
+    return 2;
+  }
+  Stats::setFile( argv[ 2 ] );
+  pRadio->save( pFile, isBinaryName( argv[ 3 ] ), 0 );
+  int result = fclose( pFile ) == 0 ? 0 : 2;
+  delete pRadio;
+  return result;
+}
+
+static int generateCommand( int                argc,
+                            char const * const argv[] ) {
+  if ( argc != 5 ) {
+    fprintf( stderr, "*** Parameter error;  wrong number of parameters ***\n" );
+    return 3;
+  }
+  int model = Generate::find( argv[ 2 ] );
+  if ( model < 0 ) {
+    fprintf( stderr, "*** Unknown model: '%s' ***\n  Models:", argv[ 2 ] );
+    for ( size_t index = 0;  index < Generate::count();  index++ ) {
+      fprintf( stderr, " %s", Generate::name( index ) );
+    }
+    fputc( '\n', stderr );
+    return 3;
+  }
+  char  * pTemp;
+  Radio * pRadio = Generate::image( model, strtoul( argv[ 3 ], & pTemp, 10 ) );
+  if ( *pTemp != 0  ||  pRadio == 0 ) {
+    fprintf( stderr, "*** Unable to generate %s image (seed '%s') ***\n", argv[ 2 ], argv[ 3 ] );
+    delete pRadio;
+    return 2;
+  }
+  FILE  * pFile  = fopen( argv[ 4 ], "wb" );
+  if ( pFile == 0 ) {
+    fprintf( stderr, "*** Unable to write file: '%s' ***\n", argv[ 4 ] );
+    delete pRadio;
+    return 2;
+  }
+  pRadio->save( pFile, Generate::isBinary( model ), 0 );
+  fclose( pFile );
+  delete pRadio;
+  return 0;
+}
+
+static int benchCommand( int                argc,
+                         char const * const argv[] ) {
+  if ( argc > 4 ) {
+    fprintf( stderr, "*** Parameter error;  too many parameters ***\n" );
+    return 3;
+  }
+  char * pTemp   = 0;
+  double seconds = argc > 3 ? strtod( argv[ 3 ], & pTemp ) : 0.5;
+  if ( pTemp != 0  &&  (*pTemp != 0  ||  seconds <= 0) ) {
+    fprintf( stderr, "*** Parameter error;  invalid seconds '%s' ***\n", argv[ 3 ] );
+    return 3;
+  }
+  char const * pModel = argc > 2  &&  strcmp( argv[ 2 ], "all" ) != 0 ? argv[ 2 ] : 0;
+  return Bench::run( pModel, seconds ) ? 0 : 2;
+}
+
+static int batchCommand( int                argc,
+                         char const * const argv[] ) {
+  if ( argc < 4 ) {
+    fprintf( stderr, "*** Parameter error;  too few parameters ***\n" );
+    return 3;
+  }
+  return Batch::run( argv[ 2 ], argc - 3, & argv[ 3 ] ) ? 0 : 2;
+}
+
+static int serveCommand( int                argc,
+                         char const * const argv[] ) {
+  if ( argc < 3  ||  argc > 4 ) {
+    fprintf( stderr, "*** Parameter error;  wrong number of parameters ***\n" );
+    return 3;
+  }
+  char * pTemp   = 0;
+  long   threads = argc > 3 ? strtol( argv[ 3 ], & pTemp, 10 ) : 4;
+  if ( pTemp != 0  &&  (*pTemp != 0  ||  threads < 1  ||  threads > Server::MAX_THREADS) ) {
+    fprintf( stderr, "*** Parameter error;  invalid threads '%s' ***\n", argv[ 3 ] );
+    return 3;
+  }
+  return Server::run( argv[ 2 ], threads );
+}
+
+static int sessionCommand( int                argc,
+                           char const * const argv[] ) {
+  Session session;
+  for ( int index = 2;  index < argc;  index++ ) {
+    if ( !session.open( argv[ index ] ) ) {
+      return 2;
+    }
+  }
+  session.run( stdin, stdout );
+  return 0;
+}
+
+static struct {
+  char const * pName;
+  int       (* pCommand)( int argc, char const * const argv[] );
+} const commands[] = {
+  { "--store",    storeCommand    },
+  { "--restore",  restoreCommand  },
+  { "--diff",     diffCommand     },
+  { "--patch",    patchCommand    },
+  { "--convert",  convertCommand  },
+  { "--merge",    mergeCommand    },
+  { "--dupes",    dupesCommand    },
+  { "--compact",  compactCommand  },
+  { "--sort",     sortCommand     },
+  { "--generate", generateCommand },
+  { "--bench",    benchCommand    },
+  { "--serve",    serveCommand    },
+  { "--batch",    batchCommand    },
+  { "--session",  sessionCommand  }
+};
+
 int __cdecl main( int                argc,
                   char const * const argv[] ) {
   FILE       * pFile;
   Radio      * pRadio;
-  char         Icf[]    = ".ICF";
-  bool         isBinary = false;
+  bool         isBinary,
+               isJson  = false,
+               isArrow = false;
+  Filter       filter;
+  char const * pWhere  = 0,
+             * pFields = 0;
+  Radio::Ranges ranges;
+  Arena        arena;
 
 
   fprintf( stderr, version );
+  while ( argc > 1 ) {                       // global options
+    if ( strcmp( argv[ 1 ], "--stats" ) == 0 ) {
+      Stats::enable();
+      argv++;
+      argc--;
+    } else if ( strcmp( argv[ 1 ], "--json" ) == 0 ) {
+      isJson = true;
+      argv++;
+      argc--;
+    } else if ( strcmp( argv[ 1 ], "--arrow" ) == 0 ) {
+      isArrow = true;
+      argv++;
+      argc--;
+    } else if ( strcmp( argv[ 1 ], "--where" ) == 0 ) {
+      if ( argc < 3 ) {
+        fprintf( stderr, "*** Parameter error;  --where needs one Expression ***\n" );
+        return 3;
+      }
+      if ( !filter.compile( argv[ 2 ] ) ) {
+        return 3;
+      }
+      pWhere = argv[ 2 ];
+      argv += 2;
+      argc -= 2;
+    } else if ( strcmp( argv[ 1 ], "--channels" ) == 0 ) {
+      if ( argc < 3 ) {
+        fprintf( stderr, "*** Parameter error;  --channels needs one list of channel ranges ***\n" );
+        return 3;
+      }
+      if ( !ranges.parse( argv[ 2 ] ) ) {
+        return 3;
+      }
+      argv += 2;
+      argc -= 2;
+    } else if ( strcmp( argv[ 1 ], "--fields" ) == 0 ) {
+      if ( argc < 3 ) {
+        fprintf( stderr, "*** Parameter error;  --fields needs one list of CSV field names ***\n" );
+        return 3;
+      }
+      pFields = argv[ 2 ];
+      argv += 2;
+      argc -= 2;
+    } else if ( strcmp( argv[ 1 ], "--trace" ) == 0 ) {
+      if ( argc < 3  ||  !Stats::trace( argv[ 2 ] ) ) {
+        fprintf( stderr, "*** Parameter error;  --trace needs one writable Trace-file ***\n" );
+        return 3;
+      }
+      argv += 2;
+      argc -= 2;
+    } else {
+      break;
+    }
+  }
+  if ( isJson  &&  isArrow ) {
+    fprintf( stderr, "*** Parameter error;  --json and --arrow are exclusive ***\n" );
+    return 3;
+  }
+  for ( size_t index = 0;  argc > 1  &&  index < COUNT_OF( commands );  index++ ) {
+    if ( strcmp( argv[ 1 ], commands[ index ].pName ) == 0 ) {
+      return commands[ index ].pCommand( argc, argv );
+    }
+  }
   switch( argc ) {
   case 1:
-    fprintf( stderr, "  Usage:  Radio2csv  Radio-filein  [ Radio-fileout [ 'comment' ] ]\n"
+    fprintf( stderr, "  Usage:  Radio2csv  [ --stats ]  [ --trace Trace-file ]  [ --json | --arrow ]  [ --where Expression ]  [ --fields Names ]  [ --channels Ranges ]  Radio-filein  [ Radio-fileout [ 'comment' ] ]\n"
                      "    To export frequency memories (\"Channels\") to a CSV file:\n"
                      "\tRadio2csv  Radio-file  > CSV-file\n"
+                     "    or to NDJSON, one typed object per channel (see Json.hpp):\n"
+                     "\tRadio2csv  --json  Radio-file  > NDJSON-file\n"
+                     "    or to an Arrow IPC file of typed columns (see Arrow.hpp):\n"
+                     "\tRadio2csv  --arrow  Radio-file  > Arrow-file\n"
+                     "    or only the channels matching an expression (see Filter.hpp), e.g.:\n"
+                     "\tRadio2csv  --where \"mode = DV and rx >= 430 and rx <= 450 and rpt1 != ''\"  Radio-file\n"
+                     "    or only some fields (CSV header names), after the channel number:\n"
+                     "\tRadio2csv  --fields \"Frequency,Name\"  Radio-file  > CSV-file\n"
+                     "    or only some channels (e.g. 100-199,500), without reading the others:\n"
+                     "\tRadio2csv  --channels  Ranges  Radio-file  > CSV-file\n"
                      "    To import frequency memories (\"Channels\") from a CSV file:\n"
-                     "\tRadio2csv  Radio-oldfile  Radio-newfile  < CSV-file\n" );
+                     "\tRadio2csv  Radio-oldfile  Radio-newfile  < CSV-file\n"
+                     "    or only some fields, keeping the others of each channel already in use:\n"
+                     "\tRadio2csv  --fields \"Name\"  Radio-oldfile  Radio-newfile  < CSV-file\n"
+                     "    or only the CSV lines of some channels (the other lines are skipped):\n"
+                     "\tRadio2csv  --channels  Ranges  Radio-oldfile  Radio-newfile  < CSV-file\n"
+                     "    To add radio files to a deduplicating image store (prints each image id):\n"
+                     "\tRadio2csv  --store  Store-directory  Radio-file...\n"
+                     "    To export, or write a radio file from, a stored image:\n"
+                     "\tRadio2csv  --restore  Store-directory  id  [ Radio-fileout [ 'comment' ] ]\n"
+                     "    To make a delta file that updates one radio file to another (same model):\n"
+                     "\tRadio2csv  --diff  Radio-basefile  Radio-newfile  Delta-file\n"
+                     "    To apply a delta file to the exact radio file it was made from:\n"
+                     "\tRadio2csv  --patch  Radio-basefile  Delta-file  Radio-fileout  [ 'comment' ]\n"
+                     "    To copy the channels of one radio file into another model's (see Convert.hpp):\n"
+                     "\tRadio2csv  --convert  Radio-filein  Radio-targetfile  Radio-fileout  [ 'comment' ]\n"
+                     "    To merge radio (or CSV) files of one model, in priority order (see Merge.hpp):\n"
+                     "\tRadio2csv  --merge  [ --relocate ]  [ --dedupe ]  Radio-fileout  Radio-file  [ Radio-file | CSV-file ]...\n"
+                     "    To list the groups of duplicate channels, across radio files of any models (see Dedupe.hpp),\n"
+                     "    and optionally write each file with one channel per group to Directory:\n"
+                     "\tRadio2csv  --dupes  [ --consolidate  Directory ]  Radio-file...  > CSV-file\n"
+                     "    To move the channels in use to the front, in order or first those listed (in that order),\n"
+                     "    and optionally renumber the channels of each bank (see Compact.hpp):\n"
+                     "\tRadio2csv  --compact  [ --order  Ranges ]  [ --banks ]  Radio-filein  Radio-fileout  [ 'comment' ]\n"
+                     "    To sort the channels in use to the front by a key, then by frequency (see Sort.hpp):\n"
+                     "\tRadio2csv  --sort  rx | bank | name | mode  Radio-filein  Radio-fileout  [ 'comment' ]\n"
+                     "    To write a synthetic, fully populated radio file (same seed, same file):\n"
+                     "\tRadio2csv  --generate  Model  Seed  Radio-fileout\n"
+                     "    To time create/dump/load/save on generated images:\n"
+                     "\tRadio2csv  --bench  [ Model | all  [ Seconds ] ]\n"
+                     "    To serve conversion requests on a Unix domain socket (see Server.hpp):\n"
+                     "\tRadio2csv  --serve  Socket-path  [ Threads ]\n"
+                     "    To export many radio files, each to CSV-directory/Radio-file.csv:\n"
+                     "\tRadio2csv  --batch  CSV-directory  Radio-file...\n"
+                     "    To edit radio files held in memory, by commands on stdin (see Session.hpp):\n"
+                     "\tRadio2csv  --session  Radio-file...\n"
+                     "    --stats (before any of the above) reports phase times & counters as JSON on stderr;\n"
+                     "    --trace writes each phase as a Chrome trace event (chrome://tracing, Perfetto).\n" );
     return 1;
   case 2:
+    break;
   case 3:
   case 4:
+    if ( pWhere != 0 ) {
+      fprintf( stderr, "*** Parameter error;  --where applies only to an export ***\n" );
+      return 3;
+    }
+    if ( isJson  ||  isArrow ) {
+      fprintf( stderr, "*** Parameter error;  --%s applies only to an export ***\n", isJson ? "json" : "arrow" );
+      return 3;
+    }
     break;
   default:
      fprintf( stderr, "*** Parameter error;  too many parameters ***\n" );
@@ -457,19 +1466,25 @@ int __cdecl main( int                argc,
     fprintf( stderr, "*** File not found: '%s' ***\n", argv[ 1 ] );
     return 2;
   }
-  size_t offset = strlen( argv[ 1 ] ) - (sizeof Icf - 1);
-  if ( (int)offset > 0 ) {
-    for ( size_t index = 0;  index < sizeof Icf;  ) {
-      isBinary |= toupper( argv[ 1 ][ offset++ ] ) != Icf[ index++ ];
-    }
-  }
+  isBinary = isBinaryName( argv[ 1 ] );
+  Stats::setFile( argv[ 1 ] );
   pRadio = Radio::create( pFile, isBinary );
   fclose( pFile );
   if ( pRadio == 0 ) {
     return 2;
   }
+  uint8_t  const * pSelect = pWhere  ? filter.select( pRadio )           : 0;
+  CsvField const * pPlan   = pFields ? pRadio->project( pFields, arena ) : 0;
+  if ( (pWhere != 0  &&  pSelect == 0)  ||  (pFields != 0  &&  pPlan == 0)  ||  !ranges.fits( pRadio ) ) {
+    delete pRadio;
+    return 2;
+  }
   if ( argv[ 2 ] != 0 ) {
-    if ( ! pRadio->load( stdin ) ) {
+    Radio::Loading loading;
+    FileInput      input( stdin );
+    loading.pPlan   = pPlan;
+    loading.pRanges = ranges.count ? & ranges : 0;
+    if ( pRadio->load( input, loading, (size_t)-1 ) != Radio::DONE ) {
       fprintf( stderr, "*** Unable to load file 'stdin' ***\n" );
       return 2;
     }
@@ -478,12 +1493,31 @@ int __cdecl main( int                argc,
       fprintf( stderr, "*** Unable to write file: '%s' ***\n", argv[ 2 ] );
       return 2;
     }
+    Stats::setFile( argv[ 2 ] );
     pRadio->save( pFile, isBinary, argv[ 3 ] );
     fclose( pFile );
+  } else if ( isJson ) {
+    FileOutput output( stdout );
+    pSelect = ranges.count ? ranges.select( pRadio, pSelect, arena ) : pSelect;
+    Json::dump( pRadio, output, pSelect, pPlan );
+  } else if ( isArrow ) {
+#ifdef  _WIN32
+    _setmode( _fileno( stdout ), _O_BINARY );
+#endif
+    FileOutput output( stdout );
+    pSelect = ranges.count ? ranges.select( pRadio, pSelect, arena ) : pSelect;
+    Arrow::dump( pRadio, output, pSelect, pPlan );
   } else {
-    pRadio->dump( stdout );
+    FileOutput output( stdout );
+    if ( ranges.count ) {
+      pRadio->dump( output, ranges, pSelect, pPlan );
+    } else {
+      pRadio->dump( output, pSelect, pPlan );
+    }
   }
   delete pRadio;
 
   return 0;
 }
+
+#endif
@@ -16,6 +16,9 @@
 //  with this program; if not, write to the Free Software Foundation, Inc.,
 //  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
+#ifndef RADIO_HPP
+#define RADIO_HPP
+
 #include <assert.h>
 #include <ctype.h>
 #include <limits.h>
@@ -23,6 +26,9 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "Arena.hpp"
+#include "Stream.hpp"
+
 #ifdef  _MSC_VER
 // Rather than compile with a lower warning level, Visual Studio C++ compilation is
 // done with a "-Wall" warning level, and then warnings that are deemed unneeded are
@@ -54,9 +60,134 @@
 
 #define COUNT_OF( array )  (sizeof array / sizeof array[ 0 ])
 
+#ifdef  _WIN32
+# define NULL_DEVICE  "NUL"
+#else
+# define NULL_DEVICE  "/dev/null"
+#endif
+
+#ifdef  _MSC_VER
+# define THREAD_LOCAL  __declspec( thread )
+#else
+# define THREAD_LOCAL  __thread
+#endif
+
+// Atomic operations on shared counters & indices (size_t, uint64_t):  ATOMIC_ADD
+// returns the previous value;  ATOMIC_LOAD acquires & ATOMIC_STORE releases;
+// ATOMIC_CAS stores DESIRED if TARGET equals EXPECTED, else updates EXPECTED to
+// TARGET, and may fail spuriously, so call it in a loop.
+
+#ifdef  __GNUC__
+# define ATOMIC_ADD(   TARGET, AMOUNT            )  __atomic_fetch_add( & (TARGET), (AMOUNT), __ATOMIC_RELAXED )
+# define ATOMIC_LOAD(  TARGET                    )  __atomic_load_n(    & (TARGET),           __ATOMIC_ACQUIRE )
+# define ATOMIC_STORE( TARGET, VALUE             )  __atomic_store_n(   & (TARGET), (VALUE),  __ATOMIC_RELEASE )
+# define ATOMIC_CAS(   TARGET, EXPECTED, DESIRED )  __atomic_compare_exchange_n( & (TARGET), & (EXPECTED), (DESIRED), true, \
+                                                                                 __ATOMIC_RELAXED, __ATOMIC_RELAXED )
+#elif defined( _MSC_VER )
+# include <intrin.h>
+
+template< size_t SIZE > struct Interlocked;
+
+template<> struct Interlocked< 4 > {
+  static long load( void const volatile * pTarget ) {   // an aligned read is atomic;  no write
+    long value = *(long const volatile *)pTarget;
+    _ReadWriteBarrier();
+    return value;
+  }
+  static long exchange( void volatile * pTarget, long value ) {
+    return _InterlockedExchange( (long volatile *)pTarget, value );
+  }
+  static long compareExchange( void volatile * pTarget, long desired, long expected ) {
+    return _InterlockedCompareExchange( (long volatile *)pTarget, desired, expected );
+  }
+  static long add( void volatile * pTarget, long amount ) {
+    return _InterlockedExchangeAdd( (long volatile *)pTarget, amount );
+  }
+};
+
+template<> struct Interlocked< 8 > {  // by compare-exchange, which 32-bit x86 also has
+  static __int64 compareExchange( void volatile * pTarget, __int64 desired, __int64 expected ) {
+    return _InterlockedCompareExchange64( (__int64 volatile *)pTarget, desired, expected );
+  }
+  static __int64 load( void const volatile * pTarget ) {   // 32-bit x86 cannot read 8 bytes at once
+    return compareExchange( const_cast< void volatile * >( pTarget ), 0, 0 );
+  }
+  static __int64 add( void volatile * pTarget, __int64 amount ) {
+    __int64 previous = *(__int64 volatile *)pTarget, seen;
+    while ( (seen = compareExchange( pTarget, previous + amount, previous )) != previous ) {
+      previous = seen;
+    }
+    return previous;
+  }
+  static __int64 exchange( void volatile * pTarget, __int64 value ) {
+    __int64 previous = *(__int64 volatile *)pTarget, seen;
+    while ( (seen = compareExchange( pTarget, value, previous )) != previous ) {
+      previous = seen;
+    }
+    return previous;
+  }
+};
+
+template< typename T > inline T atomicAdd( T & target, T amount ) {
+  return (T)Interlocked< sizeof (T) >::add( & target, amount );
+}
+template< typename T > inline T atomicLoad( T const & target ) {
+  return (T)Interlocked< sizeof (T) >::load( & target );
+}
+template< typename T > inline void atomicStore( T & target, T value ) {
+  Interlocked< sizeof (T) >::exchange( & target, value );
+}
+template< typename T > inline bool atomicCas( T & target, T & expected, T desired ) {
+  T seen = (T)Interlocked< sizeof (T) >::compareExchange( & target, desired, expected );
+  if ( seen == expected ) {
+    return true;
+  }
+  expected = seen;
+  return false;
+}
+
+# define ATOMIC_ADD(   TARGET, AMOUNT            )  atomicAdd(   (TARGET), (AMOUNT)               )
+# define ATOMIC_LOAD(  TARGET                    )  atomicLoad(  (TARGET)                         )
+# define ATOMIC_STORE( TARGET, VALUE             )  atomicStore( (TARGET), (VALUE)                )
+# define ATOMIC_CAS(   TARGET, EXPECTED, DESIRED )  atomicCas(   (TARGET), (EXPECTED), (DESIRED) )
+#else
+# error "Radio2csv needs atomic operations:  build with GCC, Clang or MSVC"
+#endif
+
 typedef uint32_t bits_t;  // uint8_t & uint16_t generate slightly larger code from GCC
 
+extern FILE * pStatus;    // where the "---" & "===" progress lines go;  stderr, or 0 for none
+
+struct Diagnostic {       // an error found by the core (Radio::create, load & dump)
+  enum Code {
+    MISSING_CSV_DATA,
+    UNKNOWN_CSV_FIELD,    // header field name
+    FIRST_CSV_FIELD,      // header does not start with the channel number
+    INVALID_CHANNEL,      // line skipped
+    INVALID_FIELD,        // line skipped
+    UNKNOWN_FIELD_VALUE,  // in the image;  exported as a number
+    INVALID_FILE_HEADER,
+    FILE_TOO_LARGE,
+    INVALID_DATA_LINE,
+    UNKNOWN_RADIO
+  }      code;
+  int    channel;         // -1 if none
+  char   field[   32 ];   // CSV field name, or ""
+  char   message[ 256 ];  // as printed, without the "*** ***"
+};
+
+typedef void diagnose_t( void * pContext, Diagnostic const * pDiagnostic );
+
+extern THREAD_LOCAL diagnose_t * pDiagnose;         // where this thread's Diagnostics go;  0 prints them on stderr
+extern THREAD_LOCAL void       * pDiagnoseContext;
+extern THREAD_LOCAL size_t       quietDepth;        // > 0 suppresses this thread's progress lines
+
+void   status(   char const * pFormat, ... );  // a progress line to pStatus, unless quiet
+void   diagnose( Diagnostic::Code code, int channel, char const * pField, char const * pFormat, ... );
+
 char * parse( char ** ppLine );
+int    stricmp( char const * pLhs,    char const         * pRhs );
+bool   isBinaryName( char const * pName );   // not an ".icf" file name
 int    search( char const * pKey,    char const * const * pTable, size_t       count );
 int    search( uint16_t     key,     uint16_t     const * pTable, size_t       count );
 int    search( double       key,     double       const * pTable, size_t       count,   double precision );
@@ -64,6 +195,11 @@ int    search( uint32_t     hz,      uint32_t     const * pTable, size_t       c
 bool   escape( char       * pExport, char         const * pName,  size_t       count );
 void   strpad( char       * pTarget, size_t               count,  char const * pSource, char   pad );
 
+void     putLE(   uint8_t       * pBytes, uint64_t   value,  size_t count );  // little-endian, any host
+uint64_t getLE(   uint8_t const * pBytes, size_t     count );
+bool     putLE32( FILE          * pFile,  uint32_t   value  );
+bool     getLE32( FILE          * pFile,  uint32_t * pValue );
+
 union Endian16 {
   uint16_t value;
   char     bytes[ sizeof( uint16_t ) ];
@@ -168,26 +304,118 @@ class PackedString {
   }
 };
 
+struct ImageRegion {       // a structural boundary within a radio image
+  char const * regionName;
+  size_t       offset;
+  size_t       size;
+  size_t       recordSize;    // size of one array element, or of the whole region
+};
+
+template< typename T, size_t N >
+size_t recordSize( T const (&)[ N ] ) {
+  return sizeof( T );
+}
+
+template< typename T >
+size_t recordSize( T const & ) {
+  return sizeof( T );
+}
+
+// Used within getRegions() of a class with a "pMemory" overlay of "pData":
+#define REGION( MEMBER )  { #MEMBER, (size_t)((uint8_t const *) & pMemory->MEMBER - pData), \
+                            sizeof pMemory->MEMBER, recordSize( pMemory->MEMBER ) }
+
 class Radio;
 typedef bool (Radio::*getField_t)( size_t index, char       * pExport ) const;
 typedef bool (Radio::*setField_t)( size_t index, char const * pImport );
 
 struct CsvField {
+  enum Type {             // of every value a field can export:  see Radio::getFieldType
+    TEXT,                 // quoted, up to a width
+    LABEL,                // one of the model's names
+    ON_OFF,
+    WHOLE,                // an unsigned number (in Hz where the CSV has units)
+    DECIMAL               // a number with a fraction or a sign
+  };
   char const * const fieldName;
   getField_t   const getField;
   setField_t   const setField;
 };
 
+struct ChannelColumns {   // the typed meanings of channel fields:  see ChannelFrame.hpp
+  enum Column {
+    RX_HZ,
+    TX_HZ,
+    TX_OFFSET_HZ,
+    SPLIT,
+    RX_STEP_HZ,
+    TX_STEP_HZ,
+    MODULATION,
+    FILTER,
+    SKIP_MODE,
+    FM_SQUELCH,
+    CTCSS_ENCODE_DHZ,     // tenths of a Hz
+    CTCSS_DECODE_DHZ,
+    DCS_CODE,
+    DCS_REVERSE,
+    DV_SQUELCH,
+    DV_CSQL_CODE,
+    BANK_GROUP,
+    BANK_CHANNEL,
+    NAME,                 // the first text column:  NAME_SIZE bytes per row
+    YOUR_CALL,            // CALL_SIZE bytes per row
+    RPT1_CALL,
+    RPT2_CALL,
+    COLUMNS
+  };
+  enum {
+    NAME_SIZE = 32,
+    CALL_SIZE = 8,
+    UNKNOWN   = 0xFFFFFFFF
+  };
+};
+
+struct Channel : ChannelColumns {   // one channel, from Radio::getChannel()
+  uint32_t number,                  // as in the CSV
+           present,                 // a bit per Column the model has
+           values[ NAME ];          // the numeric Columns;  UNKNOWN if absent or unknown
+  char     name[ NAME_SIZE + 1 ],   // as the model pads it
+           calls[ 3 ][ CALL_SIZE + 1 ];   // YOUR_CALL, RPT1_CALL & RPT2_CALL
+};
+
+class Pool;
+class ChannelFrame;
+
 class Radio {
  private:
-  char const * const pHeader;
+  char const *       pHeader;
+  size_t             headerLimit;  // bytes allocated for pHeader
+  size_t             model;        // index of the factory that made it (Pool slot), or MODELS
+  mutable uint32_t   present;      // ChannelFrame::columnsOf() the model, for random access;  0 until used
+  uint32_t           fill;
 
   Radio(             void              );  // Intentionally not implemented
   Radio(             Radio const & rhs );  // Intentionally not implemented
   Radio & operator=( Radio const & rhs );  // Intentionally not implemented
 
+  uint32_t        getPresent(  void                                                         ) const;  // "present", on first use
+
  protected:
   friend class FrequencySetBE_18;
+  friend class Store;
+  friend class Dedupe;
+  friend class Delta;
+  friend class Filter;
+  friend class Arrow;
+  friend class ChannelFrame;
+  friend class Convert;
+  friend class Generate;
+  friend class Json;
+  friend class Compact;
+  friend class Merge;
+  friend class Pool;
+  friend class Session;
+  friend class Sort;
   static double       const ctcssCodes[ 50 ];
   static uint16_t     const dcsCodes[  104 ];
   static uint32_t     const divisorsX3[  5 ];
@@ -219,6 +447,10 @@ class Radio {
   virtual size_t               getOffset(      void                                              ) const {
     return 0;
   }
+  virtual ImageRegion const  * getRegions(     size_t        * count                             ) const {
+    *count = 0;     // the whole image is one unstructured region
+    return 0;
+  }
 
   virtual bool                 getValid(       size_t          index                             ) const = 0;
   virtual void                 setValid(       size_t          index, bool               value   )       = 0;
@@ -233,6 +465,30 @@ class Radio {
     return true;
   }
 
+  // Exchanges two channels whole:  the channel records and every per-channel
+  // table (flags, bank map, names) byte for byte, so even unknown fields move
+  // with them.  False if the model cannot, or the two are in different sections.
+  virtual bool                 swapChannels(   size_t          a,     size_t             b       )       {
+    return false;
+  }
+  virtual size_t               getSection(     size_t          index                             ) const {
+    return 0;       // e.g. a band with its own channel array
+  }
+  static  void                 swapBytes(      void          * pA,    void             * pB, size_t size ) {
+    uint8_t * pByteA = (uint8_t *)pA;
+    uint8_t * pByteB = (uint8_t *)pB;
+    for ( size_t index = 0;  index < size;  index++ ) {
+      uint8_t byte = pByteA[ index ];
+      pByteA[ index ] = pByteB[ index ];
+      pByteB[ index ] = byte;
+    }
+  }
+  void                         swapBits(       uint8_t       * pBit,  size_t a,  size_t b        ) const {
+    bool bit = getBit( pBit, a );
+    setBit( pBit, a, getBit( pBit, b ) );
+    setBit( pBit, b, bit );
+  }
+
   virtual uint32_t             getRxFreq(      size_t          index                             ) const = 0;
   virtual bool                 setRxFreq(      size_t          index, uint32_t           value   )       = 0;
   virtual bool                _getRxFreq(      size_t          index, char             * pExport ) const {
@@ -552,19 +808,217 @@ class Radio {
 
 
   virtual CsvField const * csvHeader( void ) const = 0;
+  virtual bool             isTyped(   getField_t getField ) const {  // false if this CSV field bypasses
+    return true;                                                    // the typed getter & setter
+  }
+  virtual CsvField::Type   getFieldType( getField_t getField, size_t * pWidth ) const;   // *pWidth for TEXT
 
   Radio(  char const * pHeader, uint8_t const * pData, size_t size )
-      : pHeader( strdup( pHeader ) ), size( size ),  pData( (uint8_t *)memcpy( malloc( size ), pData, size ) ) {}
+      : pHeader( strdup( pHeader ) ), headerLimit( strlen( pHeader ) + 1 ), model( MODELS ),
+        present( 0 ), fill( 0 ), size( size ),  pData( (uint8_t *)memcpy( malloc( size ), pData, size ) ) {}
+
+  static  Radio * create( char const * pHeader, uint8_t const * pData, size_t size, bool isBinary,
+                          Radio     ** pIdle );
+  static  Radio * create( Input  & input,  bool isBinary, Radio ** pIdle, Arena * pScratch );
 
  public:
+  enum {
+    MODELS     = 16,        // at least the number of factories
+    MAX_IMAGE  = 0x100000,  // bytes
+    MAX_HEADER = 1000       // bytes of ICF "#" lines
+  };
+  enum Progress {           // after a slice of work
+    MORE,
+    DONE,
+    FAILED
+  };
+  struct Ranges {           // channel numbers as in the CSV, e.g. from "100-199,500"
+    enum {
+      MAX_RANGES = 64
+    };
+    size_t count,
+           first[ MAX_RANGES ],
+           last[  MAX_RANGES ];       // inclusive;  disjoint, & ascending unless ordered
+    Ranges( void ) : count( 0 ) {}
+    // False (with a message) if invalid.  Ordered, the ranges stay as given,
+    // and a channel in two of them is an error;  otherwise they are sorted &
+    // merged.
+    bool      parse(    char const * pText, bool isOrdered = false );
+    bool      contains( size_t       channel     ) const;   // ascending only
+    bool      fits(     Radio const * pRadio     ) const;   // false (with a message) if one is not the radio's
+    uint8_t * select(   Radio const * pRadio, uint8_t const * pSelect, Arena & arena ) const;  // as flags
+  };
+  struct Loading {          // a load() in progress, a slice at a time
+    enum {
+      SKIPPED = 0xFFFF      // an order[] for a CSV column not in the plan
+    };
+    size_t           order[ 256 ],  // csvHeader() index of each CSV column
+                     columns,       // 0 until the CSV header line is read
+                     offset,
+                     count,
+                     fields,
+                     bytes,
+                     errors,
+                     skipped;       // lines outside pRanges
+    CsvField const * pPlan;         // from project(), or 0 for every CSV column
+    Ranges   const * pRanges;       // or 0 for every channel
+    Radio          * pTrial;        // with pPlan, a copy each line is tried on first
+    Loading( void ) : columns( 0 ), pPlan( 0 ), pRanges( 0 ), pTrial( 0 ) {}
+    ~Loading( void ) {
+      delete pTrial;
+    }
+   private:
+    Loading(             Loading const & rhs );  // Intentionally not implemented
+    Loading & operator=( Loading const & rhs );  // Intentionally not implemented
+  };
+
   virtual         ~Radio( void ) {
     free( (void *)pHeader );
     free( (void *)pData   );
   }
-  static  Radio * create( FILE * pFile, bool isBinary                       );
-  virtual void    save(   FILE * pFile, bool isBinary, char const * comment );
-  virtual void    dump(   FILE * pFile                                      ) const;
-  virtual bool    load(   FILE * pFile                                      );
+  static  Radio * create( Input  & input,  bool isBinary                       ) {
+    return create( input, isBinary, 0, 0 );
+  }
+  static  Radio * create( char const * pHeader, uint8_t const * pData, size_t size, bool isBinary ) {
+    return create( pHeader, pData, size, isBinary, 0 );
+  }
+  void            digest( uint8_t * pDigest                                    ) const;  // SHA-256 of header & data
+  virtual bool    rebind( char const * pHeader, uint8_t const * pData, size_t size ); // same model & size
+  Radio *         clone(  void                                                 ) const;  // 0 unless from create()
+  virtual void    save(   Output & output, bool isBinary, char const * comment );
+  virtual void    dump(   Output & output                                      ) const;
+  void            dump(   Output & output, uint8_t const * pSelect, CsvField const * pPlan = 0 ) const {
+    size_t next = 0;
+    dump( output, next, (size_t)-1, pSelect, pPlan );
+  }
+  void            dump(   Output & output, Ranges const & ranges,
+                          uint8_t const * pSelect = 0, CsvField const * pPlan = 0 ) const;   // just those channels
+
+  // A projection of csvHeader() to the comma-separated CSV field names, in
+  // that order, after the channel number (always first);  0 (with a message)
+  // if a name is unknown.  An export then formats only those fields, and a
+  // load sets only those:  it skips other CSV columns, and a channel that is
+  // already valid keeps its other fields, instead of starting from defaults;
+  // a line with an invalid field is skipped without changing the channel.
+  CsvField const * project( char const * pNames, Arena & arena                ) const;
+  virtual bool    load(   Input  & input                                       );
+  virtual void    decode( ChannelFrame & frame                                 ) const;  // valid channels, as columns
+  virtual bool    encode( ChannelFrame const & frame                           );        // each row to its channel
+
+  // Random access, for an editor holding the image:  a channel (numbered as in
+  // the CSV) at a time, typed as in a ChannelFrame, through the model's
+  // accessors with no CSV text, heap or locks.  Concurrent readers are fine;
+  // a writer must not overlap other calls on the same Radio.  Setting a field
+  // of a channel not in use puts it in use, with the model's defaults.
+  bool            getChannel(  size_t channel, Channel & result                             ) const;  // false if not in use
+  bool            setField(    size_t channel, Channel::Column column, uint32_t value       );  // false if absent or invalid
+  bool            setText(     size_t channel, Channel::Column column, char const * pText   );
+  size_t          nextChannel( size_t channel                                               ) const;  // in use, from
+                                                                                                      // "channel";  or -1
+
+  // Slices, for callers that must not block long:  the CSV header line when
+  // "next" is 0, then channels from "next" (advanced) until "channels" more are
+  // done;  up to "lines" more CSV lines.  Each returns MORE until done.  A dump
+  // with "pSelect" (a flag per channel index, as from a Filter) skips the
+  // channels not flagged;  with "pPlan" (from project()), it has only those
+  // fields, in that order.
+  Progress        dump(   Output & output, size_t  & next,    size_t channels,
+                          uint8_t const * pSelect = 0, CsvField const * pPlan = 0 ) const;
+  Progress        load(   Input  & input,  Loading & loading, size_t lines     );
+
+  static  Radio * create( FILE   * pFile,  bool isBinary ) {
+    FileInput input( pFile );
+    return create( input, isBinary );
+  }
+  void            save(   FILE   * pFile,  bool isBinary, char const * comment ) {
+    FileOutput output( pFile );
+    save( output, isBinary, comment );
+  }
+  void            dump(   FILE   * pFile                                       ) const {
+    FileOutput output( pFile );
+    dump( output );
+  }
+  bool            load(   FILE   * pFile                                       ) {
+    FileInput input( pFile );
+    return load( input );
+  }
+};
+
+// Used by each model's factory:  the idle Radio (if any) is this model, from a Pool.
+template< class MODEL >
+MODEL * reuse( Radio * pIdle, char const * pHeader, uint8_t const * pData, size_t size ) {
+  if ( pIdle != 0 ) {
+    if ( pIdle->rebind( pHeader, pData, size ) ) {
+      return static_cast< MODEL * >( pIdle );
+    }
+    delete pIdle;
+  }
+  return new MODEL( pHeader, pData, size );
+}
+
+// The header & image read from an Input (binary, or ICF hex lines), a slice of
+// lines at a time;  Radio::create( Input & ) decodes in one slice.  The memory
+// is from the scratch Arena, so it lasts until that is reset.
+class Decoder {
+  Input         & input;
+  uint8_t       * pMemory;
+  char          * pHeader;
+  size_t          address;
+  char            line[ 1024 ];   // the next ICF line, if "hasLine"
+  bool    const   isBinary;
+  bool            isStarted,
+                  hasLine;
+  uint8_t         fill[ 5 ];
+  Decoder(             void                );  // Intentionally not implemented
+  Decoder(             Decoder const & rhs );  // Intentionally not implemented
+  Decoder & operator=( Decoder const & rhs );  // Intentionally not implemented
+ public:
+  Decoder( Input & input, bool isBinary, Arena & scratch );
+  Radio::Progress step(      size_t lines );  // up to "lines" more ICF data lines
+  char    const * getHeader( void         ) const {
+    return pHeader;
+  }
+  uint8_t const * getData(   void         ) const {
+    return pMemory;
+  }
+  size_t          getSize(   void         ) const {
+    return address;
+  }
+};
+
+// Idle Radio objects, at most one per model, rebound to each new image of
+// that model instead of a new & delete per image, and the scratch Arena for
+// reading images.  Not thread-safe:  one Pool per thread.
+class Pool {
+  Radio * pIdle[ Radio::MODELS ];
+  Arena   scratch;
+  Pool(             Pool const & rhs );  // Intentionally not implemented
+  Pool & operator=( Pool const & rhs );  // Intentionally not implemented
+ public:
+  Pool( void ) {
+    memset( pIdle, 0, sizeof pIdle );
+  }
+  ~Pool( void ) {
+    for ( size_t index = 0;  index < Radio::MODELS;  index++ ) {
+      delete pIdle[ index ];
+    }
+  }
+  Radio * create(  char const * pHeader, uint8_t const * pData, size_t size, bool isBinary ) {
+    return Radio::create( pHeader, pData, size, isBinary, pIdle );
+  }
+  Radio * create(  Input      & input,                                   bool isBinary ) {
+    return Radio::create( input, isBinary, pIdle, & scratch );
+  }
+  Arena & getScratch( void ) {          // for a Decoder
+    return scratch;
+  }
+  void    release( Radio * pRadio ) {   // instead of delete
+    if ( pRadio != 0  &&  pRadio->model < Radio::MODELS  &&  pIdle[ pRadio->model ] == 0 ) {
+      pIdle[ pRadio->model ] = pRadio;
+    } else {
+      delete pRadio;
+    }
+  }
 };
 
 class FrequencySetBE_18 {
@@ -600,3 +1054,5 @@ class FrequencySetBE_18 {
     sprintf( pWork, "%d %d %05X", divisor.rx, divisor.tx, rxFreq.hz() );
   }
 };
+
+#endif
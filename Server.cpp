@@ -0,0 +1,235 @@
+//==================================================================================================
+//  Server.cpp is the conversion daemon class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#include "Server.hpp"
+#include "Library.hpp"
+
+#ifdef  _WIN32
+
+int Server::run( char const * pPath, size_t threads ) {
+  fprintf( stderr, "*** --serve is not available on Windows ***\n" );
+  return 2;
+}
+
+#else
+
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+enum {
+  QUEUE_SIZE = 64         // accepted connections waiting for a worker
+};
+
+static int             queue[ QUEUE_SIZE ];
+static size_t          queueHead  = 0,
+                       queueCount = 0;
+static pthread_mutex_t queueMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  notEmpty   = PTHREAD_COND_INITIALIZER,
+                       notFull    = PTHREAD_COND_INITIALIZER;
+
+static bool readAll( int socket, void * pBuffer, size_t size ) {
+  for ( char * pNext = (char *)pBuffer;  size > 0;  ) {
+    ssize_t length = read( socket, pNext, size );
+    if ( length <= 0 ) {
+      if ( length < 0  &&  errno == EINTR ) {
+        continue;
+      }
+      return false;
+    }
+    pNext += length;
+    size  -= length;
+  }
+  return true;
+}
+
+static bool writeAll( int socket, void const * pBuffer, size_t size ) {
+  for ( char const * pNext = (char const *)pBuffer;  size > 0;  ) {
+    ssize_t length = write( socket, pNext, size );
+    if ( length <= 0 ) {
+      if ( length < 0  &&  errno == EINTR ) {
+        continue;
+      }
+      return false;
+    }
+    pNext += length;
+    size  -= length;
+  }
+  return true;
+}
+
+static void addMessages( MemoryOutput & messages, Library::Result const & result ) {
+  for ( size_t index = 0;  index < result.count  &&  index < Library::DIAGNOSTICS;  index++ ) {
+    messages.printf( "*** %s ***\n", result.diagnostics[ index ].message );
+  }
+  if ( result.count > Library::DIAGNOSTICS ) {
+    messages.printf( "*** (%d more) ***\n", (int)(result.count - Library::DIAGNOSTICS) );
+  }
+}
+
+void Server::serve( int            socket,
+                    char         * pBuffer,
+                    MemoryOutput & result,
+                    MemoryOutput & messages,
+                    Pool         & pool ) {
+  uint8_t request[ REQUEST_SIZE ];
+
+  while ( readAll( socket, request, sizeof request ) ) {
+    uint8_t  response[ RESPONSE_SIZE ];
+    char     operation   = request[ 0 ];
+    bool     isBinary    = (request[ 1 ] & 1) != 0;
+    size_t   imageSize   = (size_t)getLE( & request[  4 ], 4 ),
+             csvSize     = (size_t)getLE( & request[  8 ], 4 ),
+             commentSize = (size_t)getLE( & request[ 12 ], 4 );
+    uint32_t status      = OK;
+
+    result.clear();
+    messages.clear();
+    if ( (operation != 'E'  &&  operation != 'I')  ||  imageSize > MAX_IMAGE
+        ||  csvSize > MAX_CSV  ||  commentSize > MAX_COMMENT ) {
+      status = BAD_REQUEST;
+      messages.printf( "*** Invalid request ***\n" );
+    } else if ( !readAll( socket, pBuffer, imageSize + csvSize + commentSize ) ) {
+      break;
+    } else {
+      char          * pCsv     = pBuffer + imageSize,
+                    * pComment = pCsv    + csvSize;
+      Library::Result diagnostics;
+      pComment[ commentSize ] = 0;
+      Radio * pRadio = Library::create( pBuffer, imageSize, isBinary, & diagnostics, & pool );
+      addMessages( messages, diagnostics );
+      if ( pRadio == 0 ) {
+        status = FAILED;
+      } else if ( operation == 'E' ) {
+        Library::exportCsv( pRadio, result, & diagnostics );
+        addMessages( messages, diagnostics );
+      } else {
+        bool isOk = Library::importCsv( pRadio, pCsv, csvSize, & diagnostics );
+        addMessages( messages, diagnostics );
+        if ( isOk ) {
+          Library::save( pRadio, result, isBinary, commentSize ? pComment : 0, & diagnostics );
+          addMessages( messages, diagnostics );
+        } else {
+          status = FAILED;
+        }
+      }
+      pool.release( pRadio );
+      if ( !result.isComplete() ) {
+        status = FAILED;
+        result.clear();
+        messages.printf( "*** Out of memory for the result ***\n" );
+      }
+    }
+    putLE( & response[ 0 ], status,              4 );
+    putLE( & response[ 4 ], result.getSize(),    4 );
+    putLE( & response[ 8 ], messages.getSize(),  4 );
+    if ( !writeAll( socket, response,            sizeof response     )
+        ||  !writeAll( socket, result.getData(),   result.getSize()   )
+        ||  !writeAll( socket, messages.getData(), messages.getSize() )
+        ||  status == BAD_REQUEST ) {
+      break;
+    }
+  }
+}
+
+void * Server::work( void * pArgument ) {  // buffers & Radios are per worker, so requests don't allocate
+  MemoryOutput result,
+               messages;
+  Pool         pool;
+  char       * pBuffer = (char *)pArgument;   // from run(), so a failed malloc() stops the server
+  for ( ;; ) {
+    pthread_mutex_lock( & queueMutex );
+    while ( queueCount == 0 ) {
+      pthread_cond_wait( & notEmpty, & queueMutex );
+    }
+    int socket = queue[ queueHead ];
+    queueHead = (queueHead + 1) % QUEUE_SIZE;
+    queueCount--;
+    pthread_cond_signal( & notFull );
+    pthread_mutex_unlock( & queueMutex );
+    serve( socket, pBuffer, result, messages, pool );
+    close( socket );
+  }
+  return 0;
+}
+
+int Server::run( char const * pPath, size_t threads ) {
+  struct sockaddr_un address;
+
+  if ( strlen( pPath ) >= sizeof address.sun_path ) {
+    fprintf( stderr, "*** Socket path too long: '%s' ***\n", pPath );
+    return 2;
+  }
+  memset( & address, 0, sizeof address );
+  address.sun_family = AF_UNIX;
+  strcpy( address.sun_path, pPath );
+  struct stat info;
+  if ( lstat( pPath, & info ) == 0 ) {
+    if ( !S_ISSOCK( info.st_mode ) ) {      // never replace a file that is not a stale socket
+      fprintf( stderr, "*** Parameter error;  '%s' exists and is not a socket ***\n", pPath );
+      return 3;
+    }
+    unlink( pPath );
+  }
+  int listener = socket( AF_UNIX, SOCK_STREAM, 0 );
+  if ( listener < 0
+      ||  bind( listener, (struct sockaddr *)& address, sizeof address ) != 0
+      ||  listen( listener, QUEUE_SIZE ) != 0 ) {
+    fprintf( stderr, "*** Unable to listen on socket: '%s' (%s) ***\n", pPath, strerror( errno ) );
+    return 2;
+  }
+  signal( SIGPIPE, SIG_IGN );   // a client that hangs up just ends its connection
+  for ( size_t index = 0;  index < threads;  index++ ) {
+    pthread_t thread;
+    char    * pBuffer = (char *)malloc( MAX_IMAGE + MAX_CSV + MAX_COMMENT + 1 );
+    if ( pBuffer == 0 ) {
+      fprintf( stderr, "*** Unable to allocate worker buffer ***\n" );
+      return 2;
+    }
+    if ( pthread_create( & thread, 0, work, pBuffer ) != 0 ) {
+      free( pBuffer );
+      fprintf( stderr, "*** Unable to start worker thread ***\n" );
+      return 2;
+    }
+    pthread_detach( thread );
+  }
+  status( "--- Serving on '%s' with %d threads ---\n", pPath, (int)threads );
+  for ( ;; ) {
+    int connection = accept( listener, 0, 0 );
+    if ( connection < 0 ) {
+      if ( errno == EINTR  ||  errno == ECONNABORTED ) {
+        continue;
+      }
+      fprintf( stderr, "*** Unable to accept connection (%s) ***\n", strerror( errno ) );
+      return 2;
+    }
+    pthread_mutex_lock( & queueMutex );
+    while ( queueCount == QUEUE_SIZE ) {
+      pthread_cond_wait( & notFull, & queueMutex );
+    }
+    queue[ (queueHead + queueCount++) % QUEUE_SIZE ] = connection;
+    pthread_cond_signal( & notEmpty );
+    pthread_mutex_unlock( & queueMutex );
+  }
+}
+
+#endif
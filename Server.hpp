@@ -0,0 +1,69 @@
+//==================================================================================================
+//  Server.hpp is the conversion daemon class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  "--serve" listens on a Unix domain socket and converts through the Library
+//  interface on a pool of worker threads, one connection per worker at a time.
+//  A socket left at the path by an earlier server is replaced;  any other file
+//  there is a parameter error.
+//  A connection carries any number of requests, each answered in order:
+//
+//    request:   1 byte operation:  'E' export the image as CSV,
+//                                  'I' import the CSV into the image & return the image;
+//               1 byte flags:  bit 0 set for a binary (not ICF) image;  2 zero bytes;
+//               u32 image size, u32 CSV size, u32 comment size;
+//               the image, CSV & comment bytes ('I' only for CSV & comment).
+//    response:  u32 status (OK, FAILED, BAD_REQUEST), u32 result size,
+//               u32 diagnostics size;  the result (CSV or image) bytes;
+//               the diagnostics, one "*** ***" message per line.
+//
+//  All integers are little-endian.  BAD_REQUEST also closes the connection.
+//  Not available on Windows.
+
+#ifndef SERVER_HPP
+#define SERVER_HPP
+
+#include "Radio.hpp"
+
+class Server {
+  Server(             void               );  // Intentionally not implemented
+  Server(             Server const & rhs );  // Intentionally not implemented
+  Server & operator=( Server const & rhs );  // Intentionally not implemented
+
+ public:
+  enum {
+    OK          = 0,
+    FAILED      = 1,
+    BAD_REQUEST = 2
+  };
+  enum {
+    REQUEST_SIZE  =   16,
+    RESPONSE_SIZE =   12,
+    MAX_IMAGE     = 0x400000,
+    MAX_CSV       = 0x400000,
+    MAX_COMMENT   =  256,
+    MAX_THREADS   =   64
+  };
+
+  static int run( char const * pPath, size_t threads );   // returns only on error
+
+ private:
+  static void * work(  void * pArgument );   // "pArgument":  the worker's buffer
+  static void   serve( int    socket, char * pBuffer, MemoryOutput & result, MemoryOutput & messages, Pool & pool );
+};
+
+#endif
@@ -0,0 +1,346 @@
+//==================================================================================================
+//  Session.cpp is the interactive edit session class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#include "Session.hpp"
+
+static char const help[] =
+  "  images                      the open images, & changes to each since opened or saved\n"
+  "  open   Radio-file           open another image, which becomes the current one\n"
+  "  use    Image                make image 1, 2, ... the current one\n"
+  "  show   [ Ranges ]           CSV of those channels (e.g. 100-199,500), or all of them\n"
+  "  filter Expression           CSV of the channels matching a --where Expression\n"
+  "  set    Channel  Field=Value set one CSV field (by its header name) as an import would\n"
+  "  copy   From  To             copy a channel;  \"Image:Channel\" names one in another image\n"
+  "  move   From  To             copy a channel, then erase the original\n"
+  "  erase  Ranges               take channels out of use\n"
+  "  save   [ Radio-fileout [ 'comment' ] ]   write the current image (to its own file)\n"
+  "  quit\n";
+
+static char * word( char ** ppText ) {    // the next blank-separated word, & skips the blanks after it
+  char * pResult = *ppText;
+  *ppText += strcspn( *ppText, " \t" );
+  if ( **ppText != 0 ) {
+    *(*ppText)++ = 0;
+  }
+  *ppText += strspn( *ppText, " \t" );
+  return pResult;
+}
+
+static bool isSame( CsvField const & lhs,      // the same meaning, if typed;  else the same name
+                    CsvField const & rhs ) {
+  int column = ChannelFrame::columnOf( lhs.getField );
+  return column >= 0 ? column == ChannelFrame::columnOf( rhs.getField )
+                     : stricmp( lhs.fieldName, rhs.fieldName ) == 0;
+}
+
+Session::~Session( void ) {
+  for ( size_t index = 0;  index < images;  index++ ) {
+    delete image[ index ].pRadio;
+    free( image[ index ].pName );
+  }
+}
+
+bool Session::open( char const * pName ) {
+  if ( images == MAX_IMAGES ) {
+    fprintf( stderr, "*** Too many images;  at most %d ***\n", MAX_IMAGES );
+    return false;
+  }
+  FILE * pFile = fopen( pName, "rb" );
+  if ( pFile == 0 ) {
+    fprintf( stderr, "*** File not found: '%s' ***\n", pName );
+    return false;
+  }
+  Image & opened = image[ images ];
+  opened.changes = 0;
+  opened.pRadio  = Radio::create( pFile, isBinaryName( pName ) );
+  fclose( pFile );
+  if ( opened.pRadio == 0 ) {
+    return false;
+  }
+  opened.pName = strdup( pName );
+  current      = images++;
+  return true;
+}
+
+void Session::run( FILE * pInput,
+                   FILE * pOutput ) {
+  FileOutput output( pOutput );
+  char       line[ MAX_LINE ];
+  while ( fgets( line, sizeof line, pInput ) != 0 ) {
+    line[ strcspn( line, "\r\n" ) ] = 0;
+    bool isMore = command( line + strspn( line, " \t" ), output );
+    fflush( pOutput );
+    if ( !isMore ) {
+      break;
+    }
+  }
+}
+
+bool Session::command( char   * pLine,
+                       Output & output ) {
+  char * pVerb = word( & pLine );
+  if ( *pVerb == 0  ||  *pVerb == '#' ) {
+    return true;
+  }
+  if ( strcmp( pVerb, "quit" ) != 0 ) {
+    quits = 0;
+  } else {
+    for ( size_t index = 0;  index < images  &&  quits == 0;  index++ ) {
+      if ( image[ index ].changes > 0 ) {
+        fprintf( stderr, "*** Image %d ('%s') is not saved;  'quit' again to discard its changes ***\n",
+                 (int)index + 1, image[ index ].pName );
+        quits++;
+        return true;
+      }
+    }
+    return false;
+  }
+  if ( strcmp( pVerb, "help" ) == 0 ) {
+    output.printf( "%s", help );
+  } else if ( strcmp( pVerb, "open" ) == 0 ) {
+    open( pLine );
+  } else if ( strcmp( pVerb, "images" ) == 0 ) {
+    for ( size_t index = 0;  index < images;  index++ ) {
+      Radio const * pRadio = image[ index ].pRadio;
+      size_t        count  = 0;
+      for ( size_t channel = pRadio->nextChannel( 0 );  channel != (size_t)-1;
+                   channel = pRadio->nextChannel( channel + 1 ) ) {
+        count++;
+      }
+      output.printf( "%c%d %s:  %d of %d channels in use, %d changes\n", index == current ? '>' : ' ',
+                     (int)index + 1, image[ index ].pName, (int)count, (int)pRadio->getCount(),
+                     (int)image[ index ].changes );
+    }
+  } else if ( images == 0 ) {
+    fprintf( stderr, "*** No image is open;  'open' one first ***\n" );
+  } else if ( strcmp( pVerb, "use" ) == 0 ) {
+    char * pTemp;
+    size_t index = strtoul( pLine, & pTemp, 10 ) - 1;
+    if ( *pTemp != 0  ||  index >= images ) {
+      fprintf( stderr, "*** Invalid image '%s';  1 to %d ***\n", pLine, (int)images );
+    } else {
+      current = index;
+    }
+  } else if ( strcmp( pVerb, "show" ) == 0 ) {
+    Radio::Ranges ranges;
+    if ( *pLine == 0 ) {
+      image[ current ].pRadio->dump( output );
+    } else if ( ranges.parse( pLine )  &&  ranges.fits( image[ current ].pRadio ) ) {
+      image[ current ].pRadio->dump( output, ranges );
+    }
+  } else if ( strcmp( pVerb, "filter" ) == 0 ) {
+    uint8_t const * pSelect = filter.compile( pLine ) ? filter.select( image[ current ].pRadio ) : 0;
+    if ( pSelect != 0 ) {
+      image[ current ].pRadio->dump( output, pSelect );
+    }
+  } else if ( strcmp( pVerb, "set" ) == 0 ) {
+    set( pLine, output );
+  } else if ( strcmp( pVerb, "copy" ) == 0  ||  strcmp( pVerb, "move" ) == 0 ) {
+    copy( pLine, output, *pVerb == 'm' );
+  } else if ( strcmp( pVerb, "erase" ) == 0 ) {
+    erase( pLine );
+  } else if ( strcmp( pVerb, "save" ) == 0 ) {
+    save( pLine );
+  } else {
+    fprintf( stderr, "*** Unknown command '%s';  'help' lists them ***\n", pVerb );
+  }
+  return true;
+}
+
+bool Session::locate( char const * pText,
+                      size_t     * pImage,
+                      size_t     * pIndex ) const {
+  char       * pTemp;
+  size_t       number     = strtoul( pText, & pTemp, 10 );
+  size_t       imageIndex = current;
+  if ( *pTemp == ':'  &&  pTemp != pText ) {
+    imageIndex = number - 1;
+    number     = strtoul( pTemp + 1, & pTemp, 10 );
+  }
+  Radio const * pRadio = imageIndex < images ? image[ imageIndex ].pRadio : 0;
+  if ( *pTemp != 0  ||  *pText == 0  ||  pRadio == 0  ||  number - pRadio->getOffset() >= pRadio->getCount() ) {
+    fprintf( stderr, "*** Invalid channel '%s' ***\n", pText );
+    return false;
+  }
+  *pImage = imageIndex;
+  *pIndex = number - pRadio->getOffset();
+  return true;
+}
+
+void Session::echo( size_t   imageIndex,
+                    size_t   channel,
+                    Output & output ) const {
+  Radio::Ranges ranges;
+  ranges.count      = 1;
+  ranges.first[ 0 ] = channel;
+  ranges.last[  0 ] = channel;
+  image[ imageIndex ].pRadio->dump( output, ranges );
+}
+
+bool Session::set( char   * pArguments,
+                   Output & output ) {
+  size_t imageIndex,
+         index;
+  if ( !locate( word( & pArguments ), & imageIndex, & index ) ) {
+    return false;
+  }
+  char * pValue = strchr( pArguments, '=' );
+  if ( pValue == 0 ) {
+    fprintf( stderr, "*** Expected Field=Value, not '%s' ***\n", pArguments );
+    return false;
+  }
+  char * pEnd = pValue;
+  while ( pEnd > pArguments  &&  isspace( pEnd[ -1 ] ) ) {
+    pEnd--;
+  }
+  *pEnd  = 0;
+  pValue++;
+  pValue += strspn( pValue, " \t" );
+
+  Radio          * pRadio   = image[ imageIndex ].pRadio;
+  CsvField const * csvField = pRadio->csvHeader();
+  size_t           fieldIndex = 1;
+  while ( csvField[ fieldIndex ].fieldName != 0  &&  stricmp( pArguments, csvField[ fieldIndex ].fieldName ) != 0 ) {
+    fieldIndex++;
+  }
+  if ( csvField[ fieldIndex ].fieldName == 0 ) {
+    fprintf( stderr, "*** Unknown CSV field name '%s' ***\n", pArguments );
+    return false;
+  }
+  int    channel  = (int)(index + pRadio->getOffset());
+  bool   wasValid = pRadio->getValid( index );
+  char * pText    = parse( & pValue );            // unquoted, as in a CSV file
+  char   work[ MAX_LINE ];
+  if ( !wasValid ) {
+    (pRadio->*csvField[ 0 ].setField)( index, "1" );   // in use, with the model's defaults
+  }
+  bool   isKnown  = (pRadio->*csvField[ fieldIndex ].getField)( index, work );
+  if ( !(pRadio->*csvField[ fieldIndex ].setField)( index, pText ) ) {
+    fprintf( stderr, "*** Channel %d, field '%s': Invalid field contents '%s' ***\n",
+             channel, csvField[ fieldIndex ].fieldName, pText );
+    if ( !wasValid ) {
+      (pRadio->*csvField[ 0 ].setField)( index, 0 );
+    } else if ( isKnown ) {                       // a setter may store part of its value first
+      char * pNext = work;
+      (pRadio->*csvField[ fieldIndex ].setField)( index, parse( & pNext ) );
+    }
+    return false;
+  }
+  image[ imageIndex ].changes++;
+  echo( imageIndex, channel, output );
+  return true;
+}
+
+bool Session::copy( char   * pArguments,
+                    Output & output,
+                    bool     isMove ) {
+  size_t fromImage,
+         from,
+         toImage,
+         to;
+  char * pFrom = word( & pArguments );
+  if ( !locate( pFrom, & fromImage, & from )  ||  !locate( pArguments, & toImage, & to ) ) {
+    return false;
+  }
+  Radio          * pSource      = image[ fromImage ].pRadio;
+  Radio          * pTarget      = image[ toImage   ].pRadio;
+  CsvField const * sourceFields = pSource->csvHeader();
+  CsvField const * targetFields = pTarget->csvHeader();
+  int              channel      = (int)(to + pTarget->getOffset());
+  if ( !pSource->getValid( from ) ) {
+    fprintf( stderr, "*** Channel '%s' is not in use ***\n", pFrom );
+    return false;
+  }
+  if ( pSource == pTarget  &&  from == to ) {
+    echo( toImage, channel, output );
+    return true;
+  }
+  (pTarget->*targetFields[ 0 ].setField)( to, 0 );      // the model's defaults,
+  (pTarget->*targetFields[ 0 ].setField)( to, "1" );    // for fields the source lacks
+  for ( size_t fieldIndex = 1;  targetFields[ fieldIndex ].fieldName != 0;  fieldIndex++ ) {
+    size_t sourceIndex = 1;
+    while ( sourceFields[ sourceIndex ].fieldName != 0
+           &&  !isSame( targetFields[ fieldIndex ], sourceFields[ sourceIndex ] ) ) {
+      sourceIndex++;
+    }
+    char work[ MAX_LINE ];
+    if ( sourceFields[ sourceIndex ].fieldName == 0
+        ||  !(pSource->*sourceFields[ sourceIndex ].getField)( from, work ) ) {
+      continue;
+    }
+    char * pNext = work;
+    char * pText = parse( & pNext );              // the CSV text, unquoted
+    if ( !(pTarget->*targetFields[ fieldIndex ].setField)( to, pText ) ) {
+      fprintf( stderr, "*** Channel %d, field '%s': Invalid field contents '%s'; default kept ***\n",
+               channel, targetFields[ fieldIndex ].fieldName, pText );
+    }
+  }
+  if ( isMove ) {
+    (pSource->*sourceFields[ 0 ].setField)( from, 0 );
+    image[ fromImage ].changes++;
+  }
+  image[ toImage ].changes++;
+  echo( toImage, channel, output );
+  return true;
+}
+
+bool Session::erase( char * pArguments ) {
+  Radio::Ranges ranges;
+  if ( !ranges.parse( pArguments )  ||  !ranges.fits( image[ current ].pRadio ) ) {
+    return false;
+  }
+  Radio          * pRadio   = image[ current ].pRadio;
+  CsvField const * csvField = pRadio->csvHeader();
+  size_t   const   offset   = pRadio->getOffset();
+  size_t           count    = 0;
+  for ( size_t channel = pRadio->nextChannel( 0 );  channel != (size_t)-1;
+               channel = pRadio->nextChannel( channel + 1 ) ) {
+    if ( ranges.contains( channel ) ) {
+      (pRadio->*csvField[ 0 ].setField)( channel - offset, 0 );
+      count++;
+    }
+  }
+  image[ current ].changes += count;
+  status( "--- Channels erased: %d ---\n", (int)count );
+  return true;
+}
+
+bool Session::save( char * pArguments ) {
+  Image      & saved    = image[ current ];
+  char const * pName    = *pArguments ? word( & pArguments ) : saved.pName;
+  char       * pComment = *pArguments ? pArguments : 0;
+  if ( pComment != 0  &&  (*pComment == '\''  ||  *pComment == '"') ) {
+    size_t length = strlen( pComment );
+    if ( length > 1  &&  pComment[ length - 1 ] == *pComment ) {
+      pComment[ length - 1 ] = 0;
+      pComment++;
+    }
+  }
+  FILE * pFile = fopen( pName, "wb" );
+  if ( pFile == 0 ) {
+    fprintf( stderr, "*** Unable to write file: '%s' ***\n", pName );
+    return false;
+  }
+  saved.pRadio->save( pFile, isBinaryName( saved.pName ), pComment );
+  if ( fclose( pFile ) != 0 ) {
+    fprintf( stderr, "*** Unable to write file: '%s' ***\n", pName );
+    return false;
+  }
+  saved.changes = 0;
+  return true;
+}
@@ -0,0 +1,82 @@
+//==================================================================================================
+//  Session.hpp is the interactive edit session class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  "--session" opens radio files once, keeping their images in memory, then
+//  reads commands from stdin, one per line, until "quit" or the end of input:
+//
+//    images                      the open images, & changes to each since opened or saved
+//    open   Radio-file           open another image, which becomes the current one
+//    use    Image                make image 1, 2, ... the current one
+//    show   [ Ranges ]           CSV of those channels (e.g. 100-199,500), or all of them
+//    filter Expression           CSV of the channels matching a --where Expression
+//    set    Channel  Field=Value set one CSV field (by its header name) as an import would
+//    copy   From  To             copy a channel;  "Image:Channel" names one in another image
+//    move   From  To             copy a channel, then erase the original
+//    erase  Ranges               take channels out of use
+//    save   [ Radio-fileout [ 'comment' ] ]   write the current image (to its own file)
+//
+//  Each command touches only the channels it names, through the image in
+//  memory, and answers (CSV on stdout, "*** ***" messages on stderr) before
+//  the next line is read;  a change answers with the channels it changed.
+//  A copy between models matches fields by meaning (as in a ChannelFrame),
+//  else by CSV name;  a value the target model lacks keeps its default.
+
+#ifndef SESSION_HPP
+#define SESSION_HPP
+
+#include "Filter.hpp"
+
+class Session {
+  Session(             Session const & rhs );  // Intentionally not implemented
+  Session & operator=( Session const & rhs );  // Intentionally not implemented
+
+ public:
+  enum {
+    MAX_IMAGES = 16,
+    MAX_LINE   = 1024
+  };
+
+  Session( void ) : images( 0 ), current( 0 ), quits( 0 ) {}
+  ~Session( void );
+
+  bool open( char const * pName );             // false (with a message) if not
+  void run(  FILE * pInput, FILE * pOutput );  // until "quit" or the end of input
+
+ private:
+  struct Image {
+    Radio * pRadio;
+    char  * pName;
+    size_t  changes;         // since opened or saved
+  };
+
+  Image  image[ MAX_IMAGES ];
+  size_t images,
+         current;
+  size_t quits;              // "quit"s in a row, with changes not saved
+  Filter filter;
+
+  bool command( char * pLine, Output & output );   // false to quit
+  bool locate(  char const * pText, size_t * pImage, size_t * pIndex ) const;  // "Channel" or "Image:Channel"
+  bool set(     char * pArguments, Output & output );
+  bool copy(    char * pArguments, Output & output, bool isMove );
+  bool erase(   char * pArguments );
+  bool save(    char * pArguments );
+  void echo(    size_t imageIndex, size_t channel, Output & output ) const;   // the CSV of one channel
+};
+
+#endif
@@ -0,0 +1,149 @@
+//==================================================================================================
+//  Sort.cpp is the channel sort class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#include "Sort.hpp"
+#include "Compact.hpp"
+#include "Stats.hpp"
+
+static char const * const keyNames[ Sort::KEYS ] = { "rx", "bank", "name", "mode" };
+
+int Sort::keyOf( char const * pName ) {
+  for ( size_t key = 0;  key < KEYS;  key++ ) {
+    if ( stricmp( pName, keyNames[ key ] ) == 0 ) {
+      return (int)key;
+    }
+  }
+  fprintf( stderr, "*** Parameter error;  unknown sort key '%s' (rx, bank, name or mode) ***\n", pName );
+  return -1;
+}
+
+int Sort::compare( void const * pLhs,
+                   void const * pRhs ) {
+  Entry const * pLeft  = (Entry const *)pLhs;
+  Entry const * pRight = (Entry const *)pRhs;
+  if ( pLeft->section != pRight->section ) {
+    return pLeft->section < pRight->section ? -1 : 1;
+  }
+  int result = memcmp( pLeft->text, pRight->text, sizeof pLeft->text );
+  if ( result != 0 ) {
+    return result;
+  }
+  if ( pLeft->major != pRight->major ) {
+    return pLeft->major < pRight->major ? -1 : 1;
+  }
+  if ( pLeft->minor != pRight->minor ) {
+    return pLeft->minor < pRight->minor ? -1 : 1;
+  }
+  return pLeft->index < pRight->index ? -1 : pLeft->index > pRight->index;
+}
+
+size_t Sort::run( Radio * pRadio,
+                  Key     key ) {
+  static ChannelFrame::Column const columns[ KEYS ]
+      = { ChannelFrame::RX_HZ, ChannelFrame::BANK_GROUP, ChannelFrame::NAME, ChannelFrame::MODULATION };
+  Stats::Span    span( Stats::SORT );
+  uint32_t const present  = ChannelFrame::columnsOf( pRadio, 0, 0 );
+  if ( (present & 1 << columns[ key ]) == 0 ) {
+    char work[ 256 ];
+    fprintf( stderr, "*** %s:  no field to sort by %s ***\n", pRadio->getComment( work ), keyNames[ key ] );
+    return (size_t)-1;
+  }
+  size_t const         channels = pRadio->getCount();
+  size_t               count;
+  char const * const * ppModes  = ChannelFrame::labelsOf( pRadio, ChannelFrame::MODULATION, & count );
+  Entry              * pEntries = (Entry  *)malloc( channels * sizeof pEntries[ 0 ] );
+  size_t             * pTarget  = (size_t *)malloc( 2 * channels * sizeof pTarget[ 0 ] );
+  if ( pEntries == 0  ||  pTarget == 0 ) {
+    fprintf( stderr, "*** Out of memory (%lu bytes) ***\n",
+             (unsigned long)(channels * (sizeof pEntries[ 0 ] + 2 * sizeof pTarget[ 0 ])) );
+    free( pTarget );
+    free( pEntries );
+    return (size_t)-1;
+  }
+  size_t             * pNext    = & pTarget[ channels ];    // the next index of each section
+  size_t               entries  = 0;
+
+  for ( size_t index = channels;  index-- > 0;  ) {
+    pTarget[ index ] = (size_t)-1;
+    pNext[ pRadio->getSection( index ) ] = index;
+  }
+  for ( size_t index = 0;  index < channels;  index++ ) {   // decode the keys
+    if ( !pRadio->getValid( index ) ) {
+      continue;
+    }
+    Entry & entry = pEntries[ entries++ ];
+    memset( entry.text, ' ', sizeof entry.text );
+    entry.section = (uint32_t)pRadio->getSection( index );
+    entry.major   = ChannelFrame::getCell( pRadio, index, ChannelFrame::RX_HZ, 0 );
+    entry.minor   = 0;
+    entry.index   = (uint32_t)index;
+    switch ( key ) {
+      case BANK: {
+        uint32_t group = ChannelFrame::getCell( pRadio, index, ChannelFrame::BANK_GROUP, 0 );
+        entry.minor = entry.major;
+        entry.major = group <= 'Z' - 'A' ? group : (uint32_t)ChannelFrame::UNKNOWN;   // after the banks
+        if ( group <= 'Z' - 'A'  &&  (present & 1 << ChannelFrame::BANK_CHANNEL) != 0 ) {
+          entry.minor = ChannelFrame::getCell( pRadio, index, ChannelFrame::BANK_CHANNEL, 0 );
+        }
+        break;
+      }
+      case NAME: {
+        char     name[ ChannelFrame::NAME_SIZE ];
+        uint32_t size = ChannelFrame::getCell( pRadio, index, ChannelFrame::NAME, name );
+        for ( size_t which = 0;  which < size;  which++ ) {
+          entry.text[ which ] = (char)toupper( name[ which ] );
+        }
+        break;
+      }
+      case MODE: {
+        char         work[ 16 ];
+        char const * pMode = work;
+        uint32_t     mode  = ChannelFrame::getCell( pRadio, index, ChannelFrame::MODULATION, 0 );
+        if ( mode < count ) {
+          pMode = ppModes[ mode ];
+        } else {
+          sprintf( work, "%u", (unsigned)mode );    // as the CSV has it
+        }
+        memcpy( entry.text, pMode, strnlen( pMode, sizeof entry.text ) );
+        break;
+      }
+      default:
+        break;
+    }
+  }
+  qsort( pEntries, entries, sizeof pEntries[ 0 ], compare );
+  for ( size_t which = 0;  which < entries;  which++ ) {
+    pTarget[ pEntries[ which ].index ] = pNext[ pEntries[ which ].section ]++;
+  }
+  size_t moved = 0;
+  for ( size_t index = 0;  index < channels;  index++ ) {   // the channels not in use follow
+    if ( pTarget[ index ] == (size_t)-1 ) {
+      pTarget[ index ] = pNext[ pRadio->getSection( index ) ]++;
+    } else {
+      moved += pTarget[ index ] != index;
+    }
+  }
+  if ( !Compact::apply( pRadio, pTarget ) ) {
+    moved = (size_t)-1;
+  } else {
+    status( "--- Sorted by %s:  %d channels in use;  moved: %d ---\n", keyNames[ key ], (int)entries, (int)moved );
+  }
+  free( pTarget );
+  free( pEntries );
+  return moved;
+}
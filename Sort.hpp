@@ -0,0 +1,66 @@
+//==================================================================================================
+//  Sort.hpp is the channel sort class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  "--sort" reorders the channels of an image by a key:  receive frequency,
+//  bank (group, then bank channel), name (ignoring case), or mode;  then by
+//  receive frequency, and then by channel number.  The keys are decoded once,
+//  through the model's typed accessors (no CSV text), into an Entry per
+//  channel in use;  sorting those gives a permutation, which Compact::apply()
+//  carries out in one pass of whole-channel swaps, so every per-channel table
+//  (and every byte not in the CSV, like "unknown1") moves with its channel.
+//  The sorted channels fill the front of the image (of each section);  the
+//  channels not in use follow them.
+
+#ifndef SORT_HPP
+#define SORT_HPP
+
+#include "ChannelFrame.hpp"
+
+class Sort {
+  Sort(             void             );  // Intentionally not implemented
+  Sort(             Sort const & rhs );  // Intentionally not implemented
+  Sort & operator=( Sort const & rhs );  // Intentionally not implemented
+
+ public:
+  enum Key {
+    FREQUENCY,
+    BANK,
+    NAME,
+    MODE,
+    KEYS
+  };
+
+  static int    keyOf( char const * pName );   // a Key, from "rx", "bank", "name" or "mode";  -1 (with a message)
+
+  // The channels in use that moved;  (size_t)-1 (with a message) if the model
+  // lacks the key's field, cannot swap channels, or if out of memory.
+  static size_t run(   Radio * pRadio, Key key );
+
+ private:
+  struct Entry {          // one channel in use;  compared in this order
+    uint32_t section;
+    char     text[ ChannelFrame::NAME_SIZE ];   // NAME, or MODE's label;  space-padded
+    uint32_t major,
+             minor,
+             index;
+  };
+
+  static int    compare( void const * pLhs, void const * pRhs );
+};
+
+#endif
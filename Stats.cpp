@@ -0,0 +1,200 @@
+//==================================================================================================
+//  Stats.cpp is the timing & counters class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#include "Stats.hpp"
+
+#ifdef  _WIN32
+# include <windows.h>
+#else
+# include <time.h>
+#endif
+
+static char const * const phaseNames[   Stats::PHASES   ] = { "decode", "detect", "dump", "load", "save",
+                                                              "read",   "write", "compact", "sort" };
+static char const * const counterNames[ Stats::COUNTERS ] = { "channels", "fields", "parseErrors",
+                                                              "bytesIn",  "bytesOut" };
+
+static char const * const queueNames[   Stats::QUEUES   ] = { "convert", "write" };
+
+bool                              Stats::isEnabled   = false;
+bool                              Stats::isReporting = false;
+uint64_t                          Stats::counters[     COUNTERS ],
+                                  Stats::phaseCounts[  PHASES   ],
+                                  Stats::phaseNanos[   PHASES   ],
+                                  Stats::queueSums[    QUEUES   ],
+                                  Stats::queueSamples[ QUEUES   ],
+                                  Stats::queueMaxima[  QUEUES   ];
+size_t                            Stats::threadCount = 0;
+THREAD_LOCAL size_t               Stats::thread      = 0;
+THREAD_LOCAL char         const * Stats::pFileName   = "";
+THREAD_LOCAL Stats::Ring         * Stats::pRing       = 0;
+FILE                            * Stats::pTrace      = 0;
+Stats::Ring                     * Stats::pRings[ TRACE_THREADS ];
+size_t                            Stats::untraced    = 0;
+
+void Stats::enable( void ) {
+  if ( !isReporting ) {
+    isEnabled   = true;
+    isReporting = true;
+    atexit( report );
+  }
+}
+
+bool Stats::trace( char const * pPath ) {
+  if ( pTrace != 0 ) {
+    return false;
+  }
+  pTrace = fopen( pPath, "w" );
+  if ( pTrace == 0 ) {
+    fprintf( stderr, "*** Unable to write file: '%s' ***\n", pPath );
+    return false;
+  }
+  isEnabled = true;
+  atexit( writeTrace );
+  return true;
+}
+
+uint64_t Stats::now( void ) {
+#ifdef  _WIN32
+  LARGE_INTEGER counter,
+                frequency;
+  QueryPerformanceCounter(   & counter   );
+  QueryPerformanceFrequency( & frequency );
+  return (uint64_t)(counter.QuadPart / frequency.QuadPart * 1000000000
+                  + counter.QuadPart % frequency.QuadPart * 1000000000 / frequency.QuadPart);
+#else
+  struct timespec time;
+  clock_gettime( CLOCK_MONOTONIC, & time );
+  return (uint64_t)time.tv_sec * 1000000000 + time.tv_nsec;
+#endif
+}
+
+void Stats::end( size_t   phase,
+                 uint64_t start ) {
+  uint64_t duration = now() - start;
+  ATOMIC_ADD( phaseCounts[ phase ], 1        );
+  ATOMIC_ADD( phaseNanos[  phase ], duration );
+  if ( pTrace != 0 ) {
+    if ( thread == 0 ) {  // registers this thread's ring;  threads are joined before writeTrace
+      thread = ATOMIC_ADD( threadCount, 1 ) + 1;
+      if ( thread <= TRACE_THREADS ) {
+        pRing        = new Ring;
+        pRing->count = 0;
+        pRings[ thread - 1 ] = pRing;
+      }
+    }
+    if ( pRing == 0 ) {
+      ATOMIC_ADD( untraced, 1 );
+      return;
+    }
+    Event & event = pRing->events[ pRing->count++ % TRACE_EVENTS ];
+    event.start     = start;
+    event.duration  = duration;
+    event.phase     = phase;
+    event.thread    = thread;
+    event.pFileName = pFileName;
+  }
+}
+
+void Stats::record( size_t queue,
+                    size_t depth ) {
+  ATOMIC_ADD( queueSums[    queue ], depth );
+  ATOMIC_ADD( queueSamples[ queue ], 1     );
+  uint64_t maximum = ATOMIC_LOAD( queueMaxima[ queue ] );
+  while ( depth > maximum  &&  !ATOMIC_CAS( queueMaxima[ queue ], maximum, (uint64_t)depth ) ) {}
+}
+
+static void writeJson( FILE * pFile, char const * pString ) {
+  fputc( '"', pFile );
+  for (  ;  *pString != 0;  pString++ ) {
+    if ( *pString == '"'  ||  *pString == '\\' ) {
+      fprintf( pFile, "\\%c", *pString );
+    } else if ( (unsigned char)*pString < ' ' ) {
+      fprintf( pFile, "\\u%04X", *pString & UCHAR_MAX );
+    } else {
+      fputc( *pString, pFile );
+    }
+  }
+  fputc( '"', pFile );
+}
+
+int Stats::byStart( void const * pLeft, void const * pRight ) {   // qsort by start time
+  uint64_t left  = (*(Event const * const *)pLeft )->start,
+           right = (*(Event const * const *)pRight)->start;
+  return left < right ? -1 : left > right;
+}
+
+void Stats::writeTrace( void ) {   // merges the threads' rings, oldest event first
+  size_t rings   = threadCount < (size_t)TRACE_THREADS ? threadCount : (size_t)TRACE_THREADS,
+         events  = 0,
+         dropped = untraced;
+  for ( size_t ring = 0;  ring < rings;  ring++ ) {
+    size_t count = pRings[ ring ]->count;
+    events  += count < TRACE_EVENTS ? count : (size_t)TRACE_EVENTS;
+    dropped += count < TRACE_EVENTS ? 0     : count - TRACE_EVENTS;
+  }
+  Event const ** ppEvents = new Event const *[ events + 1 ];
+  events = 0;
+  for ( size_t ring = 0;  ring < rings;  ring++ ) {
+    Ring const * pThreadRing = pRings[ ring ];
+    for ( size_t index = 0;  index < pThreadRing->count  &&  index < TRACE_EVENTS;  index++ ) {
+      ppEvents[ events++ ] = & pThreadRing->events[ index ];
+    }
+  }
+  qsort( ppEvents, events, sizeof *ppEvents, byStart );
+  fprintf( pTrace, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n" );
+  for ( size_t index = 0;  index < events;  index++ ) {
+    Event const & event = *ppEvents[ index ];
+    fprintf( pTrace, "%s{\"name\":\"%s\",\"cat\":\"phase\",\"ph\":\"X\",\"pid\":1,\"tid\":%lu,"
+                     "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"file\":",
+                     index > 0 ? ",\n" : "", phaseNames[ event.phase ], (unsigned long)event.thread,
+                     event.start / 1e3, event.duration / 1e3 );
+    writeJson( pTrace, event.pFileName );
+    fprintf( pTrace, "}}" );
+  }
+  fprintf( pTrace, "\n]}\n" );
+  fclose( pTrace );
+  delete[] ppEvents;
+  for ( size_t ring = 0;  ring < rings;  ring++ ) {
+    delete pRings[ ring ];
+  }
+  if ( dropped > 0 ) {
+    fprintf( stderr, "*** Trace rings full;  %lu events dropped ***\n", (unsigned long)dropped );
+  }
+}
+
+void Stats::report( void ) {
+  fprintf( stderr, "{\"phases\":{" );
+  for ( size_t phase = 0;  phase < PHASES;  phase++ ) {
+    fprintf( stderr, "%s\"%s\":{\"count\":%lu,\"seconds\":%.9f}", phase ? "," : "", phaseNames[ phase ],
+                     (unsigned long)phaseCounts[ phase ], phaseNanos[ phase ] / 1e9 );
+  }
+  fprintf( stderr, "},\"counters\":{" );
+  for ( size_t counter = 0;  counter < COUNTERS;  counter++ ) {
+    fprintf( stderr, "%s\"%s\":%lu", counter ? "," : "", counterNames[ counter ],
+                     (unsigned long)counters[ counter ] );
+  }
+  fprintf( stderr, "},\"queues\":{" );
+  for ( size_t queue = 0;  queue < QUEUES;  queue++ ) {
+    fprintf( stderr, "%s\"%s\":{\"samples\":%lu,\"mean\":%.2f,\"max\":%lu}", queue ? "," : "",
+                     queueNames[ queue ], (unsigned long)queueSamples[ queue ],
+                     queueSamples[ queue ] ? (double)queueSums[ queue ] / queueSamples[ queue ] : 0.0,
+                     (unsigned long)queueMaxima[ queue ] );
+  }
+  fprintf( stderr, "}}\n" );
+}
@@ -0,0 +1,147 @@
+//==================================================================================================
+//  Stats.hpp is the timing & counters class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Monotonic-clock spans around each phase of a conversion, and counters of
+//  the work done, reported as JSON on stderr at exit ("--stats").  With
+//  "--trace", each span is also kept (the last TRACE_EVENTS of them, in a ring)
+//  as a Chrome trace event, labelled with the file being processed, and the
+//  ring is written to the trace file at exit for chrome://tracing or Perfetto.
+//  When neither is enabled, each span or counter costs one test of "isEnabled".
+//  Counts are updated atomically, so any thread may record;  the file label
+//  is per thread, and each thread's trace events carry its own "tid".
+
+#ifndef STATS_HPP
+#define STATS_HPP
+
+#include "Radio.hpp"
+
+class Stats {
+  Stats(             void              );  // Intentionally not implemented
+  Stats(             Stats const & rhs );  // Intentionally not implemented
+  Stats & operator=( Stats const & rhs );  // Intentionally not implemented
+
+ public:
+  enum Phase {
+    DECODE,               // reading the file & ICF hex decode
+    DETECT,               // model detection
+    DUMP,
+    LOAD,
+    SAVE,
+    READ,                 // --batch:  a file's asynchronous read, from submission to completion
+    WRITE,                // --batch:  a CSV file's asynchronous write, likewise
+    COMPACT,              // --compact:  the permutation, the channel moves & any bank renumbering
+    SORT,                 // --sort:  the keys, the permutation & the channel moves
+    PHASES
+  };
+  enum Counter {
+    CHANNELS,             // channels dumped or loaded
+    FIELDS,               // fields formatted or parsed
+    PARSE_ERRORS,         // rejected input lines & fields, and unknown image field values
+    BYTES_IN,
+    BYTES_OUT,
+    COUNTERS
+  };
+  enum Queue {            // depths sampled at each push
+    CONVERT_QUEUE,        // --batch:  files read, waiting to be converted
+    WRITE_QUEUE,          // --batch:  files converted, waiting to be written
+    QUEUES
+  };
+  enum {
+    TRACE_EVENTS  = 65536,  // ring size per thread;  older events are overwritten
+    TRACE_THREADS = 256     // threads traced;  later threads are counted, not recorded
+  };
+
+  class Span {            // times its own lifetime
+    uint64_t const start;
+    size_t         phase;
+    Span(             void             );  // Intentionally not implemented
+    Span(             Span const & rhs );  // Intentionally not implemented
+    Span & operator=( Span const & rhs );  // Intentionally not implemented
+   public:
+    Span( Phase phase ) : start( isEnabled ? now() : 0 ), phase( phase ) {}
+    ~Span( void ) {
+      stop();
+    }
+    void stop( void ) {   // ends the span early (once)
+      if ( isEnabled  &&  phase < PHASES ) {
+        Stats::end( phase, start );
+        phase = PHASES;
+      }
+    }
+  };
+
+  static bool     isEnabled;
+
+  static void     enable(  void );
+  static bool     trace(   char const * pPath );
+  static void     setFile( char const * pName ) {   // label for the following trace events
+    pFileName = pName;
+  }
+  static uint64_t now(     void );   // monotonic nanoseconds
+  static void     endSpan( Phase phase, uint64_t start ) {   // for a span no scope holds, from
+    if ( isEnabled ) {                                     // "start" (now(), or 0 if disabled)
+      end( phase, start );
+    }
+  }
+  static void     add(    Counter counter, uint64_t amount ) {
+    if ( isEnabled ) {
+      ATOMIC_ADD( counters[ counter ], amount );
+    }
+  }
+  static void     sample( Queue   queue,   size_t   depth  ) {
+    if ( isEnabled ) {
+      record( queue, depth );
+    }
+  }
+
+ private:
+  struct Event {
+    uint64_t     start,
+                 duration;
+    size_t       phase,
+                 thread;
+    char const * pFileName;
+  };
+  struct Ring {           // one per thread, so writers never share an event
+    size_t count;         // total recorded;  the ring holds the last TRACE_EVENTS
+    Event  events[ TRACE_EVENTS ];
+  };
+
+  static uint64_t     counters[     COUNTERS ],
+                      phaseCounts[  PHASES   ],
+                      phaseNanos[   PHASES   ],
+                      queueSums[    QUEUES   ],
+                      queueSamples[ QUEUES   ],
+                      queueMaxima[  QUEUES   ];
+  static bool         isReporting;
+  static size_t       threadCount;
+  static THREAD_LOCAL size_t       thread;       // 1-based trace "tid";  0 until it first records
+  static THREAD_LOCAL char const * pFileName;
+  static THREAD_LOCAL Ring       * pRing;        // 0 until it first records, or if untraced
+  static FILE       * pTrace;
+  static Ring       * pRings[ TRACE_THREADS ];   // registered by thread - 1;  merged by writeTrace
+  static size_t       untraced;      // events of threads beyond TRACE_THREADS
+
+  static void         end(        size_t phase, uint64_t start );
+  static void         record(     size_t queue, size_t   depth );
+  static void         report(     void );
+  static void         writeTrace( void );
+  static int          byStart(    void const * pLeft, void const * pRight );
+};
+
+#endif
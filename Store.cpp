@@ -0,0 +1,347 @@
+//==================================================================================================
+//  Store.cpp is the deduplicating image store class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#include "Store.hpp"
+
+#include <sys/stat.h>
+#ifdef  _WIN32
+# include <direct.h>
+# define mkdir( PATH, MODE )  _mkdir( PATH )
+#endif
+
+static char const manifestMagic[] = "R2CM";
+
+enum {
+  manifestVersion = 1,
+  maxPath         = FILENAME_MAX + 80
+};
+
+Store::Store( char const * pDirectory )
+    : pDirectory( strdup( pDirectory ) ), pIndex( 0 ), pChunks( 0 ),
+      pEntries( 0 ), entryCount( 0 ), entryLimit( 0 ), pSlots( 0 ), slotCount( 0 ) {
+  assert( sizeof( Entry ) == ENTRY_SIZE );
+}
+
+Store::~Store( void ) {
+  if ( pIndex != 0 ) {
+    fclose( pIndex );
+  }
+  if ( pChunks != 0 ) {
+    fclose( pChunks );
+  }
+  free( pEntries   );
+  free( pSlots     );
+  free( pDirectory );
+}
+
+void Store::makePath( char * pPath, char const * pName, char const * pSuffix ) const {
+  sprintf( pPath, "%.*s/%.80s%.8s", FILENAME_MAX - 1, pDirectory, pName, pSuffix );
+}
+
+bool Store::open( bool isWriting ) {
+  char path[ maxPath ];
+
+  if ( pIndex != 0 ) {
+    return true;
+  }
+  if ( isWriting ) {
+    mkdir( pDirectory, 0777 );
+  }
+  makePath( path, "chunks", ".idx" );
+  pIndex = fopen( path, "r+b" );
+  if ( pIndex == 0  &&  isWriting ) {
+    pIndex = fopen( path, "w+b" );
+  }
+  if ( pIndex == 0 ) {
+    fprintf( stderr, "*** Unable to open store index: '%s' ***\n", path );
+    return false;
+  }
+  makePath( path, "chunks", ".dat" );
+  pChunks = fopen( path, "r+b" );
+  if ( pChunks == 0  &&  isWriting ) {
+    pChunks = fopen( path, "w+b" );
+  }
+  if ( pChunks == 0 ) {
+    fprintf( stderr, "*** Unable to open store chunks: '%s' ***\n", path );
+    return false;
+  }
+  if ( !isWriting ) {
+    return true;    // chunks are located by ordinal;  the index isn't loaded
+  }
+
+  // A writer needs every digest to deduplicate against;  a partial entry at
+  // the end of the index (from an interrupted writer) is ignored & overwritten.
+  uint8_t bytes[ ENTRY_SIZE ];
+  while ( fread( bytes, sizeof bytes, 1, pIndex ) == 1 ) {
+    if ( entryCount == entryLimit ) {
+      entryLimit = entryLimit ? entryLimit * 2 : 1024;
+      pEntries   = (Entry *)realloc( pEntries, entryLimit * sizeof pEntries[ 0 ] );
+    }
+    Entry * pEntry = & pEntries[ entryCount++ ];
+    memcpy( pEntry->digest, bytes, sizeof pEntry->digest );
+    pEntry->offset = getLE( & bytes[ Sha256::DIGEST_SIZE     ], 8 );
+    pEntry->size   = (uint32_t)getLE( & bytes[ Sha256::DIGEST_SIZE + 8 ], 4 );
+  }
+  slotCount = 1024;
+  while ( slotCount < entryCount * 2 ) {
+    slotCount *= 2;
+  }
+  pSlots = (uint32_t *)calloc( slotCount, sizeof pSlots[ 0 ] );
+  for ( size_t ordinal = 0;  ordinal < entryCount;  ordinal++ ) {
+    insert( ordinal );
+  }
+  return true;
+}
+
+size_t Store::find( uint8_t const * pDigest ) const {   // returns the slot for pDigest, used or not
+  size_t slot = (size_t)getLE( pDigest, sizeof slot ) & (slotCount - 1);
+  while ( pSlots[ slot ] != 0
+      &&  memcmp( pEntries[ pSlots[ slot ] - 1 ].digest, pDigest, Sha256::DIGEST_SIZE ) != 0 ) {
+    slot = (slot + 1) & (slotCount - 1);
+  }
+  return slot;
+}
+
+void Store::insert( size_t ordinal ) {
+  if ( (ordinal + 1) * 2 > slotCount ) {      // keep the table at most half full
+    free( pSlots );
+    slotCount *= 2;
+    pSlots     = (uint32_t *)calloc( slotCount, sizeof pSlots[ 0 ] );
+    for ( size_t index = 0;  index < ordinal;  index++ ) {
+      pSlots[ find( pEntries[ index ].digest ) ] = (uint32_t)(index + 1);
+    }
+  }
+  pSlots[ find( pEntries[ ordinal ].digest ) ] = (uint32_t)(ordinal + 1);
+}
+
+bool Store::append( uint8_t const * pChunk, size_t size, uint32_t * pOrdinal ) {
+  uint8_t digest[ Sha256::DIGEST_SIZE ];
+  Sha256::hash( pChunk, size, digest );
+
+  size_t slot = find( digest );
+  if ( pSlots[ slot ] != 0 ) {
+    *pOrdinal = pSlots[ slot ] - 1;
+    return true;
+  }
+
+  // Data first, index entry second:  an interrupted writer leaves only unreferenced data.
+  fseek( pChunks, 0, SEEK_END );
+  if ( entryCount == entryLimit ) {
+    entryLimit = entryLimit ? entryLimit * 2 : 1024;
+    pEntries   = (Entry *)realloc( pEntries, entryLimit * sizeof pEntries[ 0 ] );
+  }
+  Entry * pEntry = & pEntries[ entryCount ];
+  memcpy( pEntry->digest, digest, sizeof digest );
+  pEntry->offset = (uint64_t)ftell( pChunks );
+  pEntry->size   = (uint32_t)size;
+
+  uint8_t bytes[ ENTRY_SIZE ] = { 0 };
+  memcpy( bytes, digest, sizeof digest );
+  putLE( & bytes[ Sha256::DIGEST_SIZE     ], pEntry->offset, 8 );
+  putLE( & bytes[ Sha256::DIGEST_SIZE + 8 ], pEntry->size,   4 );
+  fseek( pIndex, (long)(entryCount * ENTRY_SIZE), SEEK_SET );
+  if ( fwrite( pChunk, 1, size, pChunks ) != size  ||  fwrite( bytes, sizeof bytes, 1, pIndex ) != 1 ) {
+    fprintf( stderr, "*** Unable to write store chunk ***\n" );
+    return false;
+  }
+  *pOrdinal = (uint32_t)entryCount;
+  insert( entryCount++ );
+  return true;
+}
+
+bool Store::put( Radio const * pRadio, bool isBinary, char * pId ) {
+  uint8_t digest[ Sha256::DIGEST_SIZE ];
+  pRadio->digest( digest );
+  Sha256::hex(    digest, pId );
+
+  char   path[ maxPath ];
+  FILE * pFile;
+  makePath( path, pId, ".rim" );
+  if ( (pFile = fopen( path, "rb" )) != 0 ) {
+    fclose( pFile );
+    status( "--- Image already stored ---\n" );
+    return true;
+  }
+  if ( !open( true ) ) {
+    return false;
+  }
+
+  // Chunk the image:  within a region, whole records up to CHUNK_SIZE;  elsewhere, CHUNK_SIZE bytes.
+  size_t              regionCount;
+  ImageRegion const * pRegions  = pRadio->getRegions( & regionCount );
+  size_t              region    = 0,
+                      length,
+                      runCount  = 0,
+                      newCount  = 0,
+                      newBytes  = 0,
+                      runLimit  = 0,
+                      chunks    = 0,
+                      firstNew  = entryCount;
+  uint32_t          * pRuns     = 0;    // (ordinal, repeat) pairs
+  for ( size_t offset = 0;  offset < pRadio->size;  offset += length, chunks++ ) {
+    while ( region < regionCount  &&  pRegions[ region ].offset + pRegions[ region ].size <= offset ) {
+      region++;
+    }
+    size_t end   = pRadio->size,
+           chunk = CHUNK_SIZE;
+    if ( region < regionCount ) {
+      if ( pRegions[ region ].offset <= offset ) {
+        end = pRegions[ region ].offset + pRegions[ region ].size;
+        if ( pRegions[ region ].recordSize <= CHUNK_SIZE ) {
+          chunk = CHUNK_SIZE / pRegions[ region ].recordSize * pRegions[ region ].recordSize;
+        }
+      } else {
+        end = pRegions[ region ].offset;  // gap before the next region
+      }
+      end = end < pRadio->size ? end : pRadio->size;
+    }
+    length = end - offset < chunk ? end - offset : chunk;
+
+    uint32_t ordinal;
+    if ( !append( & pRadio->pData[ offset ], length, & ordinal ) ) {
+      free( pRuns );
+      return false;
+    }
+    if ( ordinal >= firstNew + newCount ) {
+      newCount++;
+      newBytes += length;
+    }
+    if ( runCount > 0  &&  pRuns[ runCount * 2 - 2 ] == ordinal ) {
+      pRuns[ runCount * 2 - 1 ]++;
+    } else {
+      if ( runCount == runLimit ) {
+        runLimit = runLimit ? runLimit * 2 : 256;
+        pRuns    = (uint32_t *)realloc( pRuns, runLimit * 2 * sizeof pRuns[ 0 ] );
+      }
+      pRuns[ runCount * 2     ] = ordinal;
+      pRuns[ runCount * 2 + 1 ] = 1;
+      runCount++;
+    }
+  }
+  fflush( pChunks );
+  fflush( pIndex  );
+
+  // Written under a temporary name, so that a manifest is never seen incomplete.
+  char   temp[ maxPath ];
+  size_t headerLength = strlen( pRadio->pHeader );
+  uint8_t prefix[ 8 ] = { 0 };
+  memcpy( prefix, manifestMagic, 4 );
+  prefix[ 4 ] = manifestVersion;
+  prefix[ 5 ] = isBinary;
+  makePath( temp, pId, ".tmp" );
+  bool isOk = (pFile = fopen( temp, "wb" )) != 0;
+  if ( isOk ) {
+    isOk = fwrite( prefix, sizeof prefix, 1, pFile ) == 1
+        && putLE32( pFile, (uint32_t)pRadio->size )
+        && putLE32( pFile, (uint32_t)headerLength )
+        && fwrite( pRadio->pHeader, 1, headerLength, pFile ) == headerLength
+        && putLE32( pFile, (uint32_t)runCount );
+    for ( size_t index = 0;  isOk  &&  index < runCount * 2;  index++ ) {
+      isOk = putLE32( pFile, pRuns[ index ] );
+    }
+    isOk = fclose( pFile ) == 0  &&  isOk;
+    remove( path );
+    isOk = isOk  &&  rename( temp, path ) == 0;
+  }
+  free( pRuns );
+  if ( !isOk ) {
+    fprintf( stderr, "*** Unable to write store manifest: '%s' ***\n", path );
+    remove( temp );
+    return false;
+  }
+  status( "--- Chunks: %d, runs: %d, new: %d (%d bytes) ---\n",
+          (int)chunks, (int)runCount, (int)newCount, (int)newBytes );
+  return true;
+}
+
+Radio * Store::get( char const * pId, bool * pIsBinary ) {
+  uint8_t digest[ Sha256::DIGEST_SIZE ];
+  if ( !Sha256::unhex( pId, digest ) ) {
+    fprintf( stderr, "*** Invalid image id: '%s' ***\n", pId );
+    return 0;
+  }
+
+  char   path[ maxPath ];
+  FILE * pFile;
+  makePath( path, pId, ".rim" );
+  if ( (pFile = fopen( path, "rb" )) == 0 ) {
+    fprintf( stderr, "*** Image not found in store: '%s' ***\n", pId );
+    return 0;
+  }
+  if ( !open( false ) ) {
+    fclose( pFile );
+    return 0;
+  }
+
+  uint8_t  prefix[ 8 ];
+  uint32_t size,
+           headerLength,
+           runCount;
+  char   * pHeader = 0;
+  uint8_t* pData   = 0;
+  bool     isOk    = fread( prefix, sizeof prefix, 1, pFile ) == 1
+                  && memcmp( prefix, manifestMagic, 4 ) == 0  &&  prefix[ 4 ] == manifestVersion
+                  && getLE32( pFile, & size )
+                  && getLE32( pFile, & headerLength );
+  if ( isOk ) {
+    pHeader = (char    *)malloc( headerLength + 1 );
+    pData   = (uint8_t *)malloc( size );
+    isOk    = fread( pHeader, 1, headerLength, pFile ) == headerLength
+           && getLE32( pFile, & runCount );
+    pHeader[ isOk ? headerLength : 0 ] = 0;
+  }
+
+  // Each run's chunk is read once, however many times it repeats.
+  size_t offset = 0;
+  for ( uint32_t run = 0;  isOk  &&  run < runCount;  run++ ) {
+    uint32_t ordinal,
+             repeat;
+    uint8_t  bytes[ ENTRY_SIZE ];
+    isOk = getLE32( pFile, & ordinal )  &&  getLE32( pFile, & repeat )  &&  repeat > 0
+        && fseek( pIndex, (long)ordinal * ENTRY_SIZE, SEEK_SET ) == 0
+        && fread( bytes, sizeof bytes, 1, pIndex ) == 1;
+    if ( isOk ) {
+      size_t length = (size_t)getLE( & bytes[ Sha256::DIGEST_SIZE + 8 ], 4 );
+      isOk = offset + length * repeat <= size
+          && fseek( pChunks, (long)getLE( & bytes[ Sha256::DIGEST_SIZE ], 8 ), SEEK_SET ) == 0
+          && fread( & pData[ offset ], 1, length, pChunks ) == length;
+      for ( offset += length;  isOk  &&  --repeat > 0;  offset += length ) {
+        memcpy( & pData[ offset ], & pData[ offset - length ], length );
+      }
+    }
+  }
+  fclose( pFile );
+
+  uint8_t check[ Sha256::DIGEST_SIZE ];
+  if ( isOk ) {
+    Sha256 sha256;
+    sha256.update( pHeader, headerLength );
+    sha256.update( pData,   size );
+    sha256.final(  check );
+  }
+  Radio * pRadio = 0;
+  if ( !isOk  ||  offset != size  ||  memcmp( check, digest, sizeof digest ) != 0 ) {
+    fprintf( stderr, "*** Store image is damaged: '%s' ***\n", pId );
+  } else {
+    *pIsBinary = prefix[ 5 ] != 0;
+    pRadio     = Radio::create( pHeader, pData, size, *pIsBinary );
+  }
+  free( pHeader );
+  free( pData   );
+  return pRadio;
+}
@@ -0,0 +1,76 @@
+//==================================================================================================
+//  Store.hpp is the deduplicating image store class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  A store is a directory holding:
+//    chunks.dat  the unique chunks, appended in arrival order;
+//    chunks.idx  one fixed-size entry (SHA-256, offset, size) per unique chunk;
+//    <id>.rim    one manifest per image:  the file header, and the image as
+//                a run-length list of chunk ordinals.
+//  Images are chunked at the structural boundaries reported by getRegions(),
+//  so an edited channel changes only the chunk holding it, and every chunk of
+//  a fill region is the same chunk.  An image <id> is the SHA-256 of its file
+//  header followed by its data.  Only one writer may use a store at a time.
+
+#ifndef STORE_HPP
+#define STORE_HPP
+
+#include "Hash.hpp"
+
+class Store {
+ public:
+  enum {
+    CHUNK_SIZE = 1024,  // target chunk size;  records are never split below it
+    ENTRY_SIZE =   48   // chunks.idx entry:  digest, 8-byte offset, 4-byte size, 4 zero bytes
+  };
+
+ private:
+  struct Entry {
+    uint64_t offset;
+    uint32_t size;
+    uint8_t  digest[ Sha256::DIGEST_SIZE ];
+    uint8_t  fill[ 4 ];
+  };
+
+  char     * const pDirectory;
+  FILE     *       pIndex;
+  FILE     *       pChunks;
+  Entry    *       pEntries;
+  size_t           entryCount,
+                   entryLimit;
+  uint32_t *       pSlots;     // open-addressed hash table of (entry ordinal + 1)
+  size_t           slotCount;
+
+  Store(             void              );  // Intentionally not implemented
+  Store(             Store const & rhs );  // Intentionally not implemented
+  Store & operator=( Store const & rhs );  // Intentionally not implemented
+
+  void     makePath( char * pPath, char const * pName, char const * pSuffix ) const;
+  bool     open(     bool isWriting );
+  size_t   find(     uint8_t const * pDigest ) const;
+  void     insert(   size_t ordinal );
+  bool     append(   uint8_t const * pChunk, size_t size, uint32_t * pOrdinal );
+
+ public:
+  Store( char const * pDirectory );
+  ~Store( void );
+
+  bool     put( Radio const * pRadio, bool isBinary, char * pId );
+  Radio  * get( char const  * pId,    bool * pIsBinary );
+};
+
+#endif
@@ -0,0 +1,109 @@
+//==================================================================================================
+//  Stream.cpp is the input & output stream class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#include "Stream.hpp"
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef va_copy             // pre-C99 libraries;  va_list is a simple pointer there
+# define va_copy( target, source )  ((target) = (source))
+#endif
+
+int Output::vprintf( char const * pFormat, va_list arguments ) {
+  char   work[ 1024 ],
+       * pWork = work;
+  size_t size  = sizeof work;
+  int    length;
+  for ( ;; ) {
+    va_list copy;
+    va_copy( copy, arguments );
+    length = vsnprintf( pWork, size, pFormat, copy );
+    va_end( copy );
+    if ( length >= 0  &&  (size_t)length < size ) {
+      break;
+    }
+    size = length >= 0 ? length + 1 : size * 2;   // pre-C99 libraries return -1
+    if ( pWork != work ) {
+      free( pWork );
+    }
+    pWork = (char *)malloc( size );
+  }
+  write( pWork, length );
+  if ( pWork != work ) {
+    free( pWork );
+  }
+  return length;
+}
+
+int Output::printf( char const * pFormat, ... ) {
+  va_list arguments;
+  va_start( arguments, pFormat );
+  int length = vprintf( pFormat, arguments );
+  va_end( arguments );
+  return length;
+}
+
+void Output::puts( char const * pString ) {
+  write( pString, strlen( pString ) );
+}
+
+char * MemoryInput::gets( char * pLine, size_t size ) {
+  if ( offset >= this->size  ||  size < 2 ) {
+    return 0;
+  }
+  size_t length = this->size - offset < size - 1 ? this->size - offset : size - 1;
+  char const * pEnd = (char const *)memchr( pData + offset, '\n', length );
+  if ( pEnd != 0 ) {
+    length = pEnd + 1 - (pData + offset);
+  }
+  memcpy( pLine, pData + offset, length );
+  pLine[ length ] = 0;
+  offset += length;
+  return pLine;
+}
+
+size_t MemoryInput::read( void * pBuffer, size_t size ) {
+  size_t length = this->size - offset < size ? this->size - offset : size;
+  memcpy( pBuffer, pData + offset, length );
+  offset += length;
+  return length;
+}
+
+MemoryOutput::~MemoryOutput( void ) {
+  free( pData );
+}
+
+void MemoryOutput::write( void const * pBuffer, size_t size ) {
+  if ( lost != 0 ) {      // keeps what fit, but nothing after the gap
+    lost += size;
+    return;
+  }
+  if ( this->size + size >= limit ) {
+    size_t   newLimit = (this->size + size) * 2 + 64;
+    char   * pNewData = (char *)realloc( pData, newLimit );
+    if ( pNewData == 0 ) {
+      lost = size;
+      return;
+    }
+    pData = pNewData;
+    limit = newLimit;
+  }
+  memcpy( pData + this->size, pBuffer, size );
+  this->size += size;
+  pData[ this->size ] = 0;
+}
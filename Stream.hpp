@@ -0,0 +1,137 @@
+//==================================================================================================
+//  Stream.hpp is the input & output stream class file for Radio2csv.
+//
+//  Author:  Copyright (c) 2017-2017 by Dean K. Gibson.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, version 2 of the License.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with this program; if not, write to the Free Software Foundation, Inc.,
+//  59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  The core (Radio::create, load, dump & save) reads an Input and writes an
+//  Output, so the same code serves files (FileInput, FileOutput), in-memory
+//  buffers (MemoryInput, MemoryOutput), and callers' sinks (CallbackOutput).
+
+#ifndef STREAM_HPP
+#define STREAM_HPP
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdio.h>
+
+class Input {
+ public:
+  virtual        ~Input( void ) {}
+  virtual char   * gets( char * pLine,   size_t size ) = 0;  // as fgets()
+  virtual size_t   read( void * pBuffer, size_t size ) = 0;  // as fread()
+};
+
+class Output {
+ public:
+  virtual      ~Output(  void ) {}
+  virtual void  write(   void const * pBuffer, size_t size ) = 0;
+  virtual int   vprintf( char const * pFormat, va_list arguments );
+  int           printf(  char const * pFormat, ... );
+  void          puts(    char const * pString );   // as fputs() (no newline)
+  void          putc(    char         c       ) {
+    write( & c, 1 );
+  }
+};
+
+class FileInput : public Input {
+  FILE * const pFile;
+  FileInput(             void                  );  // Intentionally not implemented
+  FileInput(             FileInput const & rhs );  // Intentionally not implemented
+  FileInput & operator=( FileInput const & rhs );  // Intentionally not implemented
+ public:
+  FileInput( FILE * pFile ) : pFile( pFile ) {}
+  virtual char   * gets( char * pLine,   size_t size ) {
+    return fgets( pLine, (int)size, pFile );
+  }
+  virtual size_t   read( void * pBuffer, size_t size ) {
+    return fread( pBuffer, 1, size, pFile );
+  }
+};
+
+class FileOutput : public Output {
+  FILE * const pFile;
+  FileOutput(             void                   );  // Intentionally not implemented
+  FileOutput(             FileOutput const & rhs );  // Intentionally not implemented
+  FileOutput & operator=( FileOutput const & rhs );  // Intentionally not implemented
+ public:
+  FileOutput( FILE * pFile ) : pFile( pFile ) {}
+  virtual void  write(   void const * pBuffer, size_t size ) {
+    fwrite( pBuffer, 1, size, pFile );
+  }
+  virtual int   vprintf( char const * pFormat, va_list arguments ) {
+    return vfprintf( pFile, pFormat, arguments );
+  }
+};
+
+class MemoryInput : public Input {
+  char const * const pData;
+  size_t       const size;
+  size_t             offset;
+  MemoryInput(             void                    );  // Intentionally not implemented
+  MemoryInput(             MemoryInput const & rhs );  // Intentionally not implemented
+  MemoryInput & operator=( MemoryInput const & rhs );  // Intentionally not implemented
+ public:
+  MemoryInput( void const * pData, size_t size )
+      : pData( (char const *)pData ), size( size ), offset( 0 ) {}
+  virtual char   * gets( char * pLine,   size_t size );
+  virtual size_t   read( void * pBuffer, size_t size );
+};
+
+class MemoryOutput : public Output {   // grows as needed;  always NUL-terminated
+  char   * pData;
+  size_t   size,
+           limit,
+           lost;          // bytes not stored since clear(), for lack of memory
+  MemoryOutput(             MemoryOutput const & rhs );  // Intentionally not implemented
+  MemoryOutput & operator=( MemoryOutput const & rhs );  // Intentionally not implemented
+ public:
+  MemoryOutput( void ) : pData( 0 ), size( 0 ), limit( 0 ), lost( 0 ) {}
+  virtual      ~MemoryOutput( void );
+  virtual void  write( void const * pBuffer, size_t size );
+  char const *  getData( void ) const {
+    return pData ? pData : "";
+  }
+  size_t        getSize( void ) const {
+    return size;
+  }
+  bool          isComplete( void ) const {   // false if a write did not fit in memory
+    return lost == 0;
+  }
+  void          clear(   void ) {
+    size = 0;
+    lost = 0;
+    if ( pData != 0 ) {
+      pData[ 0 ] = 0;
+    }
+  }
+};
+
+typedef void write_t( void * pContext, void const * pBuffer, size_t size );
+
+class CallbackOutput : public Output {
+  write_t * const pWrite;
+  void    * const pContext;
+  CallbackOutput(             void                       );  // Intentionally not implemented
+  CallbackOutput(             CallbackOutput const & rhs );  // Intentionally not implemented
+  CallbackOutput & operator=( CallbackOutput const & rhs );  // Intentionally not implemented
+ public:
+  CallbackOutput( write_t * pWrite, void * pContext ) : pWrite( pWrite ), pContext( pContext ) {}
+  virtual void  write( void const * pBuffer, size_t size ) {
+    pWrite( pContext, pBuffer, size );
+  }
+};
+
+#endif
@@ -148,6 +148,14 @@ class ThD74 : public Dstar {
   virtual size_t               getCount(          void                               ) const {
     return ThD74Memory::CHANNELS;
   }
+  virtual ImageRegion const  * getRegions(        size_t * count                       ) const {
+    static ImageRegion const regions[] = { REGION( fill1 ), REGION( comment2 ), REGION( fill2 ),
+                                           REGION( myCall ), REGION( fill3 ), REGION( set ), REGION( fill4 ),
+                                           REGION( block ), REGION( fill5 ), REGION( name ), REGION( fill6 ),
+                                           REGION( comment1 ), REGION( fill9 ) };
+    *count = COUNT_OF( regions );
+    return regions;
+  }
 
   virtual ThD74Channel       * getChannel(        size_t   index                       ) const {
     return & pMemory->block[ index / ThD74ChannelBlock::BLOCK_SIZE ].channel[ index % ThD74ChannelBlock::BLOCK_SIZE ];
@@ -164,6 +172,12 @@ class ThD74 : public Dstar {
     pMemory->set[ index ].group     = 0;
     pMemory->set[ index ].unknown   = 0xFF;
   }
+  virtual bool                 swapChannels(      size_t   a,     size_t       b       ) {
+    swapBytes( getChannel( a ),      getChannel( b ),      sizeof( ThD74Channel )      );
+    swapBytes( & pMemory->set[  a ], & pMemory->set[  b ], sizeof pMemory->set[  0 ] );
+    swapBytes( & pMemory->name[ a ], & pMemory->name[ b ], sizeof pMemory->name[ 0 ] );
+    return true;
+  }
 
   virtual uint32_t             getRxFreq(         size_t   index                       ) const {
     return getChannel( index )->rxFreq.hz();
@@ -320,6 +334,20 @@ class ThD74 : public Dstar {
   virtual bool                _setDcsReverse(  size_t          index, char const       * pImport )       {
     return strcmp( pImport, "----" ) == 0;
   }
+  virtual bool                 isTyped(        getField_t      getField                          ) const {
+    return getField != reinterpret_cast< getField_t >( & ThD74::_getDcsReverse );
+  }
+  virtual CsvField::Type       getFieldType(   getField_t      getField, size_t    * pWidth      ) const {
+    if ( getField == reinterpret_cast< getField_t >( & ThD74::_getSkipMode       )
+        ||  getField == reinterpret_cast< getField_t >( & ThD74::_getFineStepOn     ) ) {
+      return CsvField::ON_OFF;
+    }
+    if ( getField == reinterpret_cast< getField_t >( & ThD74::_getFineStepValue  )
+        ||  getField == reinterpret_cast< getField_t >( & ThD74::_getGroup          ) ) {
+      return CsvField::WHOLE;
+    }
+    return Dstar::getFieldType( getField, pWidth );
+  }
 
   virtual bits_t               getSkipMode(       size_t   index                       ) const {
     return pMemory->set[ index ].lockout;
@@ -330,7 +358,7 @@ class ThD74 : public Dstar {
   }
   virtual bool                _getSkipMode(       size_t   index, char       * pExport ) const {
     size_t value = getSkipMode( index );
-    if ( value >= sizeof booleans ) {
+    if ( value >= COUNT_OF( booleans ) ) {
       sprintf( pExport, "%d", (int) value );
       return false;
     }
@@ -352,7 +380,7 @@ class ThD74 : public Dstar {
   }
   virtual bool                _getFineStepOn(     size_t   index, char       * pExport ) const {
     size_t value = getFineStepOn( index );
-    if ( value >= sizeof booleans ) {
+    if ( value >= COUNT_OF( booleans ) ) {
       sprintf( pExport, "%d", (int) value );
       return false;
     }
@@ -519,7 +547,8 @@ CsvField const ThD74::csvFields[]
 
 Dstar * newThD74( char    const * pHeader,
                        uint8_t const * pData,
-                       size_t          size ) {
+                       size_t          size,
+                       Radio         * pIdle ) {
   return size == sizeof( ThD74Memory )
-         ? new ThD74( pHeader, pData, size ) : 0;
+         ? reuse< ThD74 >( pIdle, pHeader, pData, size ) : 0;
 }